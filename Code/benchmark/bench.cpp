@@ -0,0 +1,282 @@
+/*! @file	bench.cpp
+*
+*   @warning This is the internal benchmark of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*
+*   Micro-benchmarks of the optimiser hot paths on the shipped inputs. Every
+*   case is run on every input file and one csv line is written to stdout:
+*
+*	bench,input,sensors,requests,pdvs,iters,median_ns,min_ns
+*
+*   where @a median_ns and @a min_ns are the wall time of one operation. Run it
+*   from a directory next to @c input/ and @c Result/ (like the ensemble system)
+*   or pass input files on the command line.
+*
+*   Usage: bench [--filter <substring>] [--min-time <seconds>] [--seed <seed>] [--check] [input.csv ...]
+*
+*   With @c --check , the nearest point kernels are compared with the scalar
+*   loop instead (see @a nearestSelfCheck ) and the exit status is 1 on a
+*   mismatch.
+*
+*   @pre C++ language version ISO C++17. \\
+*	  Set SDL check to NO.
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include "../ensemble_system/cases.h"
+#include "../ensemble_system/pdvestimator.h"
+#include "../ensemble_system/cases.cpp"
+#include "../ensemble_system/point.cpp"
+#include "../ensemble_system/sensornode.cpp"
+#include "../ensemble_system/sensorfleet.cpp"
+#include "../ensemble_system/genetic.cpp"
+#include "../ensemble_system/blackhole.cpp"
+#include "../ensemble_system/annealing.cpp"
+#include "../ensemble_system/pdv.cpp"
+#include "../ensemble_system/funcs.cpp"
+#include "../ensemble_system/fitness.cpp"
+#include "../ensemble_system/acousgraph.cpp"
+#include "../ensemble_system/distoracle.cpp"
+#include "../ensemble_system/nearest.cpp"
+#include "../ensemble_system/knnindex.cpp"
+#include "../ensemble_system/pdvestimator.cpp"
+#include "../ensemble_system/solverstats.cpp"
+#include "../ensemble_system/mpmcring.cpp"
+#include "../ensemble_system/convergence.cpp"
+#include "../ensemble_system/stoprule.cpp"
+#include "../ensemble_system/threadpool.cpp"
+#include "../ensemble_system/rng.cpp"
+#include "../ensemble_system/mappedfile.cpp"
+#include "../ensemble_system/popstore.cpp"
+#include "../ensemble_system/fleetio.cpp"
+#include "../ensemble_system/guessgen.cpp"
+#include "../ensemble_system/flighttrace.cpp"
+
+using namespace std;
+
+//! Input files used when none is given: 500, 1000 and 1500 sensor nodes from both data sets.
+static const char* DEFAULT_INPUTS[] = {
+	"../input/input0.csv",
+	"../input/input3.csv",
+	"../input/input6.csv",
+	"../Result/odp_one_results/input/inputs_sn500_neg500_pos500.csv",
+	"../Result/odp_one_results/input/inputs_sn1000_neg1000_pos1000.csv",
+	"../Result/odp_one_results/input/inputs_sn1500_neg500_pos500.csv",
+};
+
+//! Settings shared by every case.
+struct BenchConfig {
+	double min_time = 0.2;		/*!< Timed seconds per case */
+	int min_iters = 5;		/*!< Operations per case at least */
+	uint64_t seed = 1;		/*!< Seed of every optimiser */
+	string filter;			/*!< Only run cases whose name contains it */
+};
+
+//! Optimisers set up on one input, with their initial populations built and scored.
+struct BenchInput {
+	string name;
+	vector<SensorNode<double>> sn_list;
+	vector<Point<double>> sn_ps;
+	AcousGraph<double> acous;
+	Genetic<double>* ga = nullptr;
+	BlackHole<double>* bh = nullptr;
+	Annealing<double>* sa = nullptr;
+	int n_req = 0;
+	int n_pdv = 0;
+
+	~BenchInput() {
+		delete ga;
+		delete bh;
+		delete sa;
+	}
+};
+
+/*! @brief			Time one case and write its csv line.
+*   @param cfg		Benchmark settings.
+*   @param in		The input the case runs on.
+*   @param name		Name of the case.
+*   @param setup		Run untimed before every operation, may be empty.
+*   @param op		One operation.
+*/
+static void runCase(const BenchConfig& cfg, const BenchInput& in, const string& name,
+	const function<void()>& setup, const function<void()>& op) {
+	if (!cfg.filter.empty() && name.find(cfg.filter) == string::npos) return;
+
+	//! Warm up caches and lazily built state.
+	if (setup) setup();
+	op();
+
+	vector<double> samples;
+	double total = 0.;
+	while (total < cfg.min_time * 1e9 || static_cast<int>(samples.size()) < cfg.min_iters) {
+		if (setup) setup();
+		auto start = chrono::steady_clock::now();
+		op();
+		auto stop = chrono::steady_clock::now();
+		double ns = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(stop - start).count());
+		samples.push_back(ns);
+		total += ns;
+	}
+
+	sort(samples.begin(), samples.end());
+	cout << name << "," << in.name << "," << in.sn_list.size() << "," << in.n_req << "," << in.n_pdv << ","
+		<< samples.size() << "," << samples[samples.size() / 2] << "," << samples[0] << endl;
+}
+
+/*! @brief			Load an input and set up the three optimisers on it.
+*
+*   The optimisers run their own @a checkTask with no generations (and, for SA,
+*   an empty cooling schedule), so they are left with the fitness engine and the
+*   scored initial population of the first planning round.
+*
+*   @param cfg		Benchmark settings.
+*   @param fname		Path of the input csv file.
+*   @param in		The set up input.
+*   @return			False if the file cannot be read or has too few requests.
+*/
+static bool loadInput(const BenchConfig& cfg, const string& fname, BenchInput& in) {
+	InputFleet input;
+	if (!input.load(fname)) {
+		cerr << fname << " cannot open\n";
+		return false;
+	}
+	in.name = fname.substr(fname.find_last_of("/\\") + 1);
+	in.sn_list = FleetView<double>(input).read();
+	for (const SensorNode<double>& sn : in.sn_list) in.sn_ps.push_back(sn.pos);
+	in.acous.build(in.sn_list);
+
+	in.ga = new Genetic<double>(80, 20, 0, 0, 50, 50, 25, 5);
+	in.bh = new BlackHole<double>(80, 20, 0, 0, 50, 50, 25, 5);
+	in.sa = new Annealing<double>(80, 20, 0, 1e-4, 1e-3, 0.985, 25, 25, 5);
+	in.ga->seed = in.bh->seed = in.sa->seed = cfg.seed;
+	in.ga->n_threads = in.bh->n_threads = in.sa->n_threads = 1;
+
+	//! @a checkTask drains nothing, but each optimiser gets its own copy as in @a Cases .
+	vector<SensorNode<double>> ga_list = in.sn_list, bh_list = in.sn_list, sa_list = in.sn_list;
+	if (!in.ga->checkTask(0, ga_list) || !in.bh->checkTask(0, bh_list) || !in.sa->checkTask(0, sa_list)) {
+		cerr << in.name << " has too few requested sensor nodes\n";
+		return false;
+	}
+	in.n_req = in.ga->req_idx.size();
+	in.n_pdv = in.ga->best_sol.size();
+	return true;
+}
+
+//! Run every case on one input.
+static void runInput(const BenchConfig& cfg, BenchInput& in) {
+	const int n_sn = in.sn_list.size();
+	volatile double sink = 0.;
+
+	//! One point against every sensor node
+	int q = 0;
+	runCase(cfg, in, "point_calcDist", nullptr, [&]() {
+		const Point<double>& p = in.sn_ps[q++ % n_sn];
+		double sum = 0.;
+		for (int i = 0; i < n_sn; i++) sum += p.calcDist(in.sn_ps[i]);
+		sink = sum;
+	});
+
+	//! @a Cluster::assignEndNodes is replaced by the acoustic graph, built once per input
+	runCase(cfg, in, "acous_build", nullptr, [&]() {
+		AcousGraph<double> acous(in.sn_list);
+		sink = acous.getNodeNum();
+	});
+
+	//! Fitness of a whole solution, one call per sub path
+	auto fitnessCase = [&](const string& name, function<double(const vector<int>&)> func, const vector<vector<int>>& sol) {
+		runCase(cfg, in, name, nullptr, [&]() {
+			double sum = 0.;
+			for (const vector<int>& sub : sol) sum += func(sub);
+			sink = sum;
+		});
+	};
+	fitnessCase("ga_fitnessFunc", [&](const vector<int>& s) { return in.ga->fitnessFunc(s); }, in.ga->tars_int[0]);
+	fitnessCase("bh_fitnessFunc", [&](const vector<int>& s) { return in.bh->fitnessFunc(s); }, in.bh->tars_idx[0]);
+	fitnessCase("sa_fitnessFunc", [&](const vector<int>& s) { return in.sa->fitnessFunc(s); }, in.sa->tars_idx[0]);
+
+	//! Trails of the whole population
+	runCase(cfg, in, "ga_crossover", nullptr, [&]() {
+		in.ga->crossover(in.ga->cr, in.ga->pop, in.ga->tars_int, in.ga->trail_int);
+	});
+
+	//! Every PDV of one star towards the black hole, the star is reset before each move
+	vector<vector<int>> star;
+	vector<bool> dirty;
+	Rng rng(cfg.seed, 1);
+	runCase(cfg, in, "bh_attraction", [&]() {
+		star = in.bh->tars_idx[1];
+		dirty.assign(in.n_pdv, false);
+	}, [&]() {
+		for (int k = 0; k < in.n_pdv; k++) in.bh->attraction(0, k, 0, star, rng, dirty);
+	});
+
+	//! One SA move over every PDV, the chain target is copied before each move
+	runCase(cfg, in, "sa_initOneSol", [&]() {
+		star = in.sa->tars_idx[0];
+		dirty.assign(in.n_pdv, false);
+	}, [&]() {
+		for (int k = 0; k < in.n_pdv; k++) in.sa->initOneSol(k, star, rng, dirty);
+	});
+
+	//! The greedy fleet-size estimate without and with its cache
+	runCase(cfg, in, "calcOptPdvNum", nullptr, [&]() {
+		sink = PdvEstimator<double>::calcPdvNum(*in.ga->fit_eval);
+	});
+	runCase(cfg, in, "calcOptPdvNum_cached", nullptr, [&]() {
+		sink = PdvEstimator<double>::estimate(*in.ga->fit_eval);
+	});
+
+	//! The first PDV of the GA plan on a fresh copy of the sensor nodes
+	vector<Point<double>> path;
+	for (int idx : in.ga->tars_int[0][0]) path.push_back(in.sn_list[idx].pos);
+	vector<SensorNode<double>> sn_copy;
+	vector<Point<double>> path_copy;
+	runCase(cfg, in, "pdv_flightSimulation", [&]() {
+		sn_copy = in.sn_list;
+		path_copy = path;
+	}, [&]() {
+		PDV<double> pdv;
+		double charged_e = 0., pdv_t = 0.;
+		sink = pdv.flightSimulation(charged_e, pdv_t, sn_copy, path_copy, in.acous);
+	});
+}
+
+int main(int argc, char** argv) {
+	BenchConfig cfg;
+	vector<string> inputs;
+	bool check = false;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--filter") && i + 1 < argc) cfg.filter = argv[++i];
+		else if (!strcmp(argv[i], "--min-time") && i + 1 < argc) cfg.min_time = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--seed") && i + 1 < argc) cfg.seed = strtoull(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--check")) check = true;
+		else inputs.push_back(argv[i]);
+	}
+
+	if (check) {
+		int n_bad = nearestSelfCheck(cfg.seed);
+		cerr << "nearest kernels: " << (n_bad ? "FAILED" : "ok") << " (picked " << nearestKernelName() << ")\n";
+		return n_bad ? 1 : 0;
+	}
+	if (inputs.empty()) inputs.assign(begin(DEFAULT_INPUTS), end(DEFAULT_INPUTS));
+
+	cerr << "nearest kernel: " << nearestKernelName() << "\n";
+	cout << fixed << setprecision(0);
+	cout << "bench,input,sensors,requests,pdvs,iters,median_ns,min_ns" << endl;
+	for (const string& fname : inputs) {
+		BenchInput in;
+		if (!loadInput(cfg, fname, in)) continue;
+		runInput(cfg, in);
+	}
+
+	return 0;
+}
@@ -0,0 +1,91 @@
+/*! @file acousgraph.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "acousgraph.h"
+
+using namespace std;
+
+template <class T>
+AcousGraph<T>::AcousGraph() {
+	this->row_ptr.assign(1, 0);
+}
+
+template <class T>
+AcousGraph<T>::AcousGraph(const vector<SensorNode<T>>& sn_list) {
+	this->build(sn_list);
+}
+
+template <class T>
+AcousGraph<T>::~AcousGraph() {}
+
+template <class T>
+void AcousGraph<T>::build(const vector<SensorNode<T>>& sn_list) {
+	int n = sn_list.size();
+	this->row_ptr.assign(n + 1, 0);
+	this->col_idx.clear();
+	this->dist.clear();
+	if (!n) return;
+
+	double min_x = sn_list[0].pos.getX(), max_x = min_x;
+	double min_y = sn_list[0].pos.getY(), max_y = min_y;
+	for (int i = 1; i < n; i++) {
+		min_x = min(min_x, (double)sn_list[i].pos.getX());
+		max_x = max(max_x, (double)sn_list[i].pos.getX());
+		min_y = min(min_y, (double)sn_list[i].pos.getY());
+		max_y = max(max_y, (double)sn_list[i].pos.getY());
+	}
+
+	//! Cells are never smaller than the acoustic range, so the 3 x 3 block around a
+	//! node covers all its neighbours. Sparse or stretched fields use larger cells to
+	//! keep the number of cells in O(n).
+	double cell = max((double)MAX_ACOUS_DIST, sqrt((max_x - min_x) * (max_y - min_y) / n));
+	cell = max(cell, max(max_x - min_x, max_y - min_y) / n);
+	int nx = static_cast<int>((max_x - min_x) / cell) + 1;
+	int ny = static_cast<int>((max_y - min_y) / cell) + 1;
+
+	vector<int> cell_of(n);
+	vector<int> cell_ptr(nx * ny + 1, 0);
+	for (int i = 0; i < n; i++) {
+		int cx = static_cast<int>((sn_list[i].pos.getX() - min_x) / cell);
+		int cy = static_cast<int>((sn_list[i].pos.getY() - min_y) / cell);
+		cell_of[i] = cx * ny + cy;
+		cell_ptr[cell_of[i] + 1]++;
+	}
+	for (int c = 0; c < nx * ny; c++) cell_ptr[c + 1] += cell_ptr[c];
+
+	//! Counting sort keeps nodes of one cell in ascending index order.
+	vector<int> cell_nodes(n);
+	vector<int> fill(cell_ptr.begin(), cell_ptr.end() - 1);
+	for (int i = 0; i < n; i++) cell_nodes[fill[cell_of[i]]++] = i;
+
+	vector<pair<int, double>> row;
+	for (int i = 0; i < n; i++) {
+		row.clear();
+		int cx = cell_of[i] / ny, cy = cell_of[i] % ny;
+		for (int gx = max(cx - 1, 0); gx <= min(cx + 1, nx - 1); gx++) {
+			for (int gy = max(cy - 1, 0); gy <= min(cy + 1, ny - 1); gy++) {
+				int c = gx * ny + gy;
+				for (int k = cell_ptr[c]; k < cell_ptr[c + 1]; k++) {
+					int j = cell_nodes[k];
+					double d = sn_list[i].pos.calcDist(sn_list[j].pos);
+					if (d >= MAX_ACOUS_DIST || d <= 0.1) continue;
+					row.push_back(make_pair(j, d));
+				}
+			}
+		}
+
+		sort(row.begin(), row.end());
+		for (unsigned k = 0; k < row.size(); k++) {
+			this->col_idx.push_back(row[k].first);
+			this->dist.push_back(row[k].second);
+		}
+		this->row_ptr[i + 1] = this->col_idx.size();
+	}
+}
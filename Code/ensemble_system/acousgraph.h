@@ -0,0 +1,88 @@
+/*! @file	acousgraph.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include "sensornode.h"
+
+#ifndef ACOUSGRAPH_H_
+#define ACOUSGRAPH_H_
+
+/*! @class		AcousGraph acousgraph.h "acousgraph.h"
+*   @brief		Implementation of @a AcousGraph class
+*
+*   The @a AcousGraph class stores the acoustic neighbours of every sensor node
+*   in compressed sparse row (CSR) form. Node @a j is a neighbour of center node
+*   @a i if 0.1 < d(i, j) < @a MAX_ACOUS_DIST, the same rule used by
+*   @a Cluster::assignEndNodes . The graph is built once per input with a uniform
+*   spatial grid, and the neighbours of each node are kept in ascending index order.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+template <class T>
+class AcousGraph
+{
+	//! @publicsection
+public:
+	//! A default constructer with an empty graph.
+	AcousGraph();
+
+	/*! @brief			Build the graph from sensor node positions.
+	*   @param sn_list	A vector of all sensor nodes.
+	*/
+	AcousGraph(const std::vector<SensorNode<T>>& sn_list);
+
+	//! A default destructer.
+	~AcousGraph();
+
+	/*! @brief			(Re-)build the graph from sensor node positions.
+	*   @param sn_list	A vector of all sensor nodes.
+	*/
+	void build(const std::vector<SensorNode<T>>& sn_list);
+
+	/*! @brief			Access the first CSR entry of center node @a i .
+	*   @param i		The index of the center node.
+	*   @return			Offset of the first neighbour in @a getNeighbour and @a getDist .
+	*/
+	int rowBegin(const int& i) const { return this->row_ptr[i]; }
+
+	/*! @brief			Access the end of CSR entries of center node @a i .
+	*   @param i		The index of the center node.
+	*   @return			Offset after the last neighbour of @a i .
+	*/
+	int rowEnd(const int& i) const { return this->row_ptr[i + 1]; }
+
+	/*! @brief			Access the sensor index stored in CSR entry @a k .
+	*   @param k		CSR offset.
+	*   @return			Index of the neighbour sensor node.
+	*/
+	int getNeighbour(const int& k) const { return this->col_idx[k]; }
+
+	/*! @brief			Access the distance stored in CSR entry @a k .
+	*   @param k		CSR offset.
+	*   @return			Distance between the center node and the neighbour [m].
+	*/
+	double getDist(const int& k) const { return this->dist[k]; }
+
+	/*! @brief			Access the number of sensor nodes in the graph.
+	*   @return			Number of rows.
+	*/
+	int getNodeNum() const { return static_cast<int>(this->row_ptr.size()) - 1; }
+
+	//! @privatesection
+private:
+	std::vector<int> row_ptr;		/*!< CSR row offsets, size n + 1 */
+	std::vector<int> col_idx;		/*!< Neighbour sensor indices */
+	std::vector<double> dist;		/*!< Distance to each neighbour [m] */
+};
+
+#endif // !ACOUSGRAPH_H_
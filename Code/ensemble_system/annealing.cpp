@@ -15,8 +15,10 @@
 #include <iostream>
 #include <algorithm>
 #include "pdv.h"
+#include "pdvestimator.h"
 #include "annealing.h"
 #include "funcs.h"
+#include "threadpool.h"
 
 using namespace std;
 
@@ -44,6 +46,8 @@ Annealing<T>::Annealing(int w_wsn_eng, int w_pdv_eng, int w_pdv_dist, double ini
 template <class T>
 Annealing<T>::~Annealing() {
 	delete this->origin;
+	delete this->fit_eval;
+	delete this->guess_gen;
 }
 
 template<class T>
@@ -69,224 +73,32 @@ void Annealing<T>::initParams(vector<SensorNode<T>*>& req_sn_ptr) {
 		this->trails_met.clear();
 	}
 	this->tars_met.resize(this->pop);
+	this->trails_met.resize(this->pop);
 }
 
 template <class T>
-void Annealing<T>::saveGuessToTxt(int pop_num, int pdv_num_txt, int sn_num, vector<int> path_to_save) {
-	string fname = "../input/initial_guess/pop" + to_string(pop_num)
-		+ "_pdv" + to_string(pdv_num_txt) + ".txt";
-
-	fstream file;
-	try {
-		file.open(fname, fstream::out);
-		if (!file.is_open())
-			throw runtime_error(strerror(errno));
-	}
-	catch (const exception& e) {
-		cerr << e.what() << "\n";
-	}
-
-	for (int i = 0; i < sn_num; i++) {
-		file << path_to_save[i];
-		if (i == sn_num - 1) {
-			file << endl;
-			break;
-		}
-		file << ",";
-	}
-	file.close();
+void Annealing<T>::saveGuessData(int case_num, const vector<vector<vector<int>>>& pop_list) {
+	PopStore::save(PopStore::casePath(case_num), pop_list);
 }
 
-template <class T>
-int Annealing<T>::calcOptPdvNum(vector<SensorNode<T>> sn_list, vector<SensorNode<T>*> req_sn_ptr, vector<Point<T>> temp_req_p) {
-	PDV<T>* temp_pdv = new PDV<T>();
-
-	int pdv_num = 1;
-	do {
-		if (temp_pdv->f_eng <= 20) {
-			pdv_num++;
-			temp_pdv->resetPdvStatus();
-			continue;
-		}
-
-		vector<double> d_list = temp_pdv->pos.calcDist(temp_req_p);
-		int next = distance(d_list.begin(), min_element(d_list.begin(), d_list.end()));
-
-		int this_cn = -1;
-		for (unsigned i = 0; i < sn_list.size(); i++) {
-			if (sn_list[i].pos.isCoincide(req_sn_ptr[next]->pos)) {
-				this_cn = i;
-				break;
-			}
-		}
-
-		double ipt_eng = 0.;
-		temp_pdv->iptEnergyCost(sn_list[this_cn], ipt_eng);
-
-		if (temp_pdv->calcEnergyCost(temp_req_p[next].calcDist(Point<T>()) / temp_pdv->getPdvSpeed())
-			+ temp_pdv->calcEnergyCost(temp_pdv->pos.calcDist(temp_req_p[next]) / temp_pdv->getPdvSpeed())
-			+ ipt_eng + 20 > temp_pdv->f_eng) {
-
-			pdv_num++;
-			temp_pdv->resetPdvStatus();
-			continue;
-		}
-
-		temp_pdv->updatePdvStatus(temp_req_p[next]);
-		temp_pdv->f_eng -= ipt_eng;
-
-		temp_req_p.erase(temp_req_p.begin() + next);
-		req_sn_ptr.erase(req_sn_ptr.begin() + next);
-	} while (temp_req_p.size());
-
-	delete temp_pdv;
-	return pdv_num;
-}
 
 
 template <class T>
-bool Annealing<T>::calcInitGuess(const int& r_num, const int& pdv_num, const int& pop_num,
-	vector<SensorNode<T>> sn_list, vector<SensorNode<T>*> req_sn_ptr, vector<Point<T>> req_ps) {
-	int len = req_sn_ptr.size();
-	int len_sub_path = len / pdv_num;
-	bool is_match = true;
-	if (len % pdv_num != 0) is_match = false;
-
-	vector<Point<T>> temp_req_p = req_ps;
-	for (int i = 0; i < pop_num; i++) {
-		//! The sub vector of @a clsts_list
-		vector<int> req_sn_list;
-		req_sn_list.reserve(len_sub_path);
-		Point<T>* temp_p = new Point<T>();
-		for (int j = 0; j < pdv_num; j++) {
+bool Annealing<T>::calcInitGuess(int case_num, const int& r_num, const int& pdv_num, const int& pop_num, ThreadPool& pool) {
+	uint64_t run_seed = this->used_seed;
+	pool.parallelFor(pop_num, [this, r_num, pdv_num, run_seed](int i, int /*worker*/) {
+		Rng rng = GuessGen<T>::memberRng(run_seed, i);
+		this->guess_gen->buildOne(r_num, pdv_num, rng, this->tars_idx[i]);
+	});
 
-			//! If not divisible, the last PDV assignment should be different
-			if (j == pdv_num - 1 && !is_match) {
-				break;
-			}
+	if (this->save_guess) this->saveGuessData(case_num, this->tars_idx);
 
-			for (int k = 0; k < len_sub_path; k++) {
-				//! Find the index randomly (the `num`th shortest)
-				vector<double> d_list = temp_p->calcDist(temp_req_p);
-				int next = distance(d_list.begin(), min_element(d_list.begin(), d_list.end()));
-
-				int sn_idx = -1;
-				for (unsigned z = 0; z < sn_list.size(); z++) {
-					if (sn_list[z].pos.isCoincide(temp_req_p[next])) {
-						sn_idx = z;
-						break;
-					}
-				}
-
-				req_sn_list.push_back(sn_idx);
-				temp_req_p.erase(temp_req_p.begin() + next);
-			}
-
-			this->saveGuessToTxt(i, j, req_sn_list.size(), req_sn_list);
-			req_sn_list.clear();
-			temp_p->setX(0.);
-			temp_p->setY(0.);
-		}
-
-		if (!is_match) {
-			do {
-				//! Find the index randomly (the `num`th shortest)
-				vector<double> d_list = temp_p->calcDist(temp_req_p);
-				int next = distance(d_list.begin(), min_element(d_list.begin(), d_list.end()));
-
-				int sn_idx = -1;
-				for (unsigned z = 0; z < sn_list.size(); z++) {
-					if (sn_list[z].pos.isCoincide(temp_req_p[next])) {
-						sn_idx = z;
-						break;
-					}
-				}
-
-				req_sn_list.push_back(sn_idx);
-				temp_req_p.erase(temp_req_p.begin() + next);
-			} while (temp_req_p.size());
-
-			this->saveGuessToTxt(i, pdv_num - 1, req_sn_list.size(), req_sn_list);
-			req_sn_list.clear();
-			temp_p->setX(0.);
-			temp_p->setY(0.);
-		}
-
-		//! Re-initialize @a temp_req_p for each population
-		temp_req_p = req_ps;
-		delete temp_p;
-	}
-
-	return is_match;
+	return this->guess_gen->isMatch(pdv_num);
 }
 
 template <class T>
-double Annealing<T>::fitnessFunc(vector<SensorNode<T>> sn_list, vector<int> idx_list) {
-	vector<Point<T>> this_flight_path;
-	this_flight_path.reserve(idx_list.size());
-	for (unsigned i = 0; i < idx_list.size(); i++) {
-		this_flight_path.push_back(sn_list[idx_list[i]].pos);
-	}
-
-	unique_ptr<PDV<T>> pdv = make_unique<PDV<T>>();
-	double charged_eng = 0., total_eng = 0.;
-
-	do {
-		vector<double> d_list = pdv->pos.calcDist(this_flight_path);
-		int next = distance(d_list.begin(), min_element(d_list.begin(), d_list.end()));
-
-		//! Implement inductive power transfer to the center node.
-		int this_cn = -1;
-		for (unsigned i = 0; i < sn_list.size(); i++) {
-			if (sn_list[i].pos.isCoincide(this_flight_path[next])) {
-				this_cn = i;
-				break;
-			}
-		}
-
-		if (pdv->calcEnergyCost(this_flight_path[next].calcDist(Point<T>()) / pdv->getPdvSpeed()) + 
-			pdv->calcEnergyCost(pdv->pos.calcDist(this_flight_path[next]) / pdv->getPdvSpeed()) > pdv->f_eng) {
-			return -1000.;
-		}
-
-		pdv->updatePdvStatus(this_flight_path[next]);
-
-		//! Update IPT energy cost
-		double ipt_eng = 0.;
-		pdv->iptEnergyCost(sn_list[this_cn], ipt_eng);
-		pdv->f_eng -= ipt_eng;
-		charged_eng += sn_list[this_cn].calcPackage() - 12.;
-		total_eng += sn_list[this_cn].calcMaxEnergy();
-
-		unique_ptr<Cluster<T>> clst = make_unique<Cluster<T>>();
-		clst->center = &sn_list[this_cn].pos;
-		clst->contains.clear();
-		clst->contains.push_back(&sn_list[this_cn]);
-		clst->assignEndNodes(sn_list);
-
-		//! Implement center node acoustic power trannsfer.
-		for (unsigned i = 1; i < clst->contains.size(); i++) {
-			auto this_sn = clst->contains[i] - &sn_list[0];
-			double temp_d = 0., temp_g = 0.;
-			temp_d = sn_list[this_sn].pos.calcDist(*clst->center);
-			temp_g = exp(-1. * pow(2 * PI * 47500, EFF_ACOUS) * temp_d * ALPHA_MAT);
-			charged_eng += EFF_PIEZO * EFF_PIEZO * EFF_ACOUS2DC * temp_g * ACOUS_ENERGY_SEND;
-		}
-
-		this_flight_path.erase(this_flight_path.begin() + next);
-	} while (this_flight_path.size());
-
-	//! Return to home process
-	pdv->updatePdvStatus(Point<T>());
-
-	auto* funcs = new Funcs<double>();
-
-	double wsn_e_fac = this->coeff_wsn_eng * funcs->tanhFunc(charged_eng / (total_eng * 0.9));		//! Wh
-	double pdv_e_fac = this->coeff_pdv_eng * funcs->invTanhFunc((187. - pdv->f_eng) / 187.);			//! Wh
-
-	double fitness = wsn_e_fac + pdv_e_fac;
-	delete funcs;
-	return fitness;
+double Annealing<T>::fitnessFunc(const vector<int>& idx_list) {
+	return this->fit_eval->calcFitness(idx_list);
 }
 
 template <class T>
@@ -302,65 +114,36 @@ int Annealing<T>::getBestSol(const int& pdv_num) {
 }
 
 template <class T>
-void Annealing<T>::initOneSol(const int& cur_pdv, vector<vector<int>>& idx_list, vector<Point<T>> req_ps, vector<SensorNode<T>> sn_list) {
-	auto* funcs = new Funcs<double>();
-	int r2 = funcs->getRandIndex(idx_list[cur_pdv].size() - 1);
+int Annealing<T>::initOneSol(const int& cur_pdv, vector<vector<int>>& idx_list, Rng& rng, vector<bool>& dirty) {
+	int r2 = rng.uniformInt(idx_list[cur_pdv].size() - 1);
 
-	vector<double> d_list = sn_list[idx_list[cur_pdv][r2]].pos.calcDist(req_ps);
 	int num = 0;
-	int temp_size = req_ps.size();
-	if (temp_size > this->max_num_r) num = funcs->getRandIndex(this->max_num_r - 1);
-	else num = funcs->getRandIndex(temp_size - 1);
+	int temp_size = this->req_idx.size();
+	if (temp_size > this->max_num_r) num = rng.uniformInt(this->max_num_r - 1);
+	else num = rng.uniformInt(temp_size - 1);
 
 	if (!num) num++;
 
-	unique_ptr<vector<double>> sort_ds = make_unique<vector<double>>(num + 1);
-	partial_sort_copy(d_list.begin(), d_list.end(), sort_ds->begin(), sort_ds->end());
-	auto it = find(d_list.begin(), d_list.end(), (*sort_ds)[num]);
-	int next = distance(d_list.begin(), it);
-
-	int sn_idx = -1;
-	for (unsigned z = 0; z < sn_list.size(); z++) {
-		if (sn_list[z].pos.isCoincide(req_ps[next])) {
-			sn_idx = z;
-			break;
-		}
-	}
+	int slot = this->fit_eval->getOracle().nthNearest(this->fit_eval->getSlot(idx_list[cur_pdv][r2]), num);
+	int sn_idx = this->req_idx[slot];
 
+	int n_swap = 0;
 	for (unsigned m = 0; m < idx_list.size(); m++) {
 		for (unsigned n = 0; n < idx_list[m].size(); n++) {
 			if (idx_list[m][n] == sn_idx) {
 				swap(idx_list[cur_pdv][r2], idx_list[m][n]);
+				n_swap++;
+				if (this->fit_eval->swapChangesScore((int)m == cur_pdv)) dirty[cur_pdv] = dirty[m] = true;
 			}
 		}
 	}
+
+	return n_swap;
 }
 
 template <class T>
-vector<int> Annealing<T>::readGuessData(int case_num, int pop_num, int pdv_num) {
-	string fname = "../input/initial_guess/case" + to_string(case_num) + "/pop" + to_string(pop_num) + "pdv" + to_string(pdv_num) + ".txt";
-	vector<int> idx_list;
-	fstream file;
-	try {
-		file.open(fname, fstream::in);
-		if (!file.is_open()) throw runtime_error(strerror(errno));
-	}
-	catch (const std::exception& e) {
-		cerr << e.what() << "\n";
-	}
-
-	string line;
-	if (file.good()) getline(file, line);
-	file.close();
-
-	stringstream ss(line);
-	idx_list.clear();
-	for (int i; ss >> i;) {
-		idx_list.push_back(i);
-		if (ss.peek() == ',') ss.ignore();
-	}
-
-	return idx_list;
+vector<int> Annealing<T>::readGuessData(int pop_num, int pdv_num) {
+	return this->guess_store.readPath(pop_num, pdv_num);
 }
 
 template <class T>
@@ -387,79 +170,239 @@ void Annealing<T>::saveSubPathToCsv(vector<SensorNode<T>> sn_list, vector<vector
 	}
 }
 
+template <class T>
+bool Annealing<T>::annealStep(int chain, double temp, Rng& rng, EvalScratch& scratch) {
+	int pdv_num = this->tars_idx[chain].size();
+	vector<vector<int>>& trail = this->trails_idx[chain];
+	vector<double>& trail_met = this->trails_met[chain];
+	bool can_finish = true;
+
+	//! Swaps may also change sub paths moved earlier, so all moves are made before re-scoring.
+	vector<bool> dirty(pdv_num, false);
+	{
+		SOLVER_PHASE(scratch.stats, MOVES);
+		trail = this->tars_idx[chain];
+		trail_met = this->tars_met[chain];
+		int n_swap = 0;
+		for (int j = 0; j < pdv_num; j++) n_swap += this->initOneSol(j, trail, rng, dirty);
+		SOLVER_COUNT(scratch.stats, SWAPS, n_swap);
+	}
+
+	double trails_met_sum = trail_met[pdv_num];
+	{
+		SOLVER_PHASE(scratch.stats, EVAL);
+		for (int j = 0; j < pdv_num; j++) {
+			if (!dirty[j]) continue;
+			double met = this->fit_eval->calcFitness(trail[j], scratch);
+			if (met == -1) {
+				can_finish = false;
+				break;
+			}
+			trails_met_sum += met - trail_met[j];
+			trail_met[j] = met;
+		}
+		if (!can_finish) {
+			trail_met.assign(pdv_num + 1, 0.);
+			trails_met_sum = -1.;
+		}
+		trail_met[pdv_num] = trails_met_sum;
+	}
+
+	SOLVER_PHASE(scratch.stats, SELECTION);
+	double delta_met = (trail_met[pdv_num] - this->tars_met[chain][pdv_num]) * SA_DELTA_SCALE;
+	if (delta_met >= 0 || exp(delta_met / temp) > rng.uniformFloat()) {
+		swap(this->tars_idx[chain], trail);
+		swap(this->tars_met[chain], trail_met);
+		SOLVER_COUNT(scratch.stats, ACCEPTED, 1);
+		return true;
+	}
+
+	return false;
+}
+
+template <class T>
+void Annealing<T>::reportChain(int case_num, int chain, int step, double temp, double accept_rate, int pdv_num) {
+	ConvergenceStream::Sample s = ConvergenceStream::Sample();
+	s.alg = static_cast<int32_t>(ConvergenceStream::Alg::SA);
+	s.case_num = case_num;
+	s.chain = chain;
+	s.step = step;
+	s.temp = temp;
+	s.best = s.mean = s.worst = this->tars_met[chain][pdv_num];
+	s.accept_rate = accept_rate;
+	this->conv->push(s);
+}
+
 template <class T>
 void Annealing<T>::calcFinalPath(int case_num, vector<SensorNode<T>>& sn_list, vector<SensorNode<T>*> candidates) {
 	//bool is_match = false;
-	int pdv_num = this->calcOptPdvNum(sn_list, candidates, this->req_ps);
-	//is_match = this->calcInitGuess(this->max_num_r, pdv_num, this->pop, sn_list, candidates, this->req_ps);
+	//! The budget covers the whole call, the fitness tables included.
+	Deadline deadline(this->stop_rule.time_budget);
+	this->req_idx.resize(candidates.size());
+	for (unsigned i = 0; i < candidates.size(); i++) this->req_idx[i] = candidates[i] - &sn_list[0];
+
+	delete this->fit_eval;
+	this->fit_eval = new FitnessEval<T>(sn_list, this->req_idx, this->coeff_wsn_eng, this->coeff_pdv_eng, this->eval_mode,
+		this->dist_budget);
+	delete this->guess_gen;
+	this->guess_gen = new GuessGen<T>(this->fit_eval->getOracle(), this->req_idx);
+	this->used_seed = this->seed ? this->seed : Rng::timeSeed();
+
+	int pdv_num = PdvEstimator<T>::estimate(*this->fit_eval);
+
+	ThreadPool pool(this->n_threads);
+	vector<EvalScratch> scratch(pool.getThreadNum());
+	this->stats.reset();
 
-	auto* funcs = new Funcs<double>();
 	auto start = chrono::high_resolution_clock::now();
 
-	this->trails_idx.resize(pdv_num);
-	this->trails_met.resize(pdv_num + 1);
+	{
+		SOLVER_PHASE(this->stats, LOAD);
+		bool loaded = this->load_guess
+			&& this->guess_gen->loadCase(this->guess_store, case_num, this->pop, pdv_num, this->tars_idx);
+		if (!loaded) {
+			this->calcInitGuess(case_num, this->max_num_r, pdv_num, this->pop, pool);
+			SOLVER_COUNT(this->stats, CLUSTER_BUILDS, this->pop * pdv_num);
+		}
+	}
 
-	for (int i = 0; i < this->pop; i++) {
-		this->tars_idx[i].resize(pdv_num);
-		this->tars_met[i].resize(pdv_num);
-		
+	pool.parallelFor(this->pop, [this, pdv_num, &scratch](int i, int worker) {
+		SOLVER_PHASE(scratch[worker].stats, INIT_SCORE);
+		this->tars_met[i].resize(pdv_num + 1);
 		double tars_met_sum = -1.;
 		for (int j = 0; j < pdv_num; j++) {
-			this->tars_idx[i][j] = this->readGuessData(case_num, i, j);
-			this->tars_met[i][j] = this->fitnessFunc(sn_list, this->tars_idx[i][j]);
+			this->tars_met[i][j] = this->fit_eval->calcFitness(this->tars_idx[i][j], scratch[worker]);
 			tars_met_sum += this->tars_met[i][j];
 		}
-		this->tars_met[i].push_back(tars_met_sum);
-	}
-
-	double temp = this->init_temp;
-	for (int i = 0; i < this->pop; i++) {
-		while (temp > this->min_temp) {
-			bool can_finish = true;
-			double trails_met_sum = -1.;
-
-			this->trails_idx = this->tars_idx[i];
-			for (int j = 0; j < pdv_num; j++) {
-				this->initOneSol(j, this->trails_idx, this->req_ps, sn_list);
-				this->trails_met[j] = this->fitnessFunc(sn_list, trails_idx[j]);
-				if (this->trails_met[j] == -1) {
-					can_finish = false;
+		this->tars_met[i][pdv_num] = tars_met_sum;
+	});
+
+	//! Every chain draws from its own stream, so chains do not share any state.
+	vector<Rng> rngs(this->pop);
+	for (int i = 0; i < this->pop; i++) rngs[i].seed(this->used_seed, i);
+
+	bool use_stop = this->stop_rule.isEnabled();
+	this->stop_reason = StopReason::COMPLETED;
+	this->steps_run = 0;
+
+	//! Steps of one cooling schedule
+	int n_steps = 0;
+	for (double temp = this->init_temp; temp > this->min_temp; temp *= this->temp_factor) n_steps++;
+
+	if (!this->tempering) {
+		//! Independent chains, each with the full cooling schedule and its own stop rules
+		//! Every chain reports its target and acceptance rate once per CONV_SA_WINDOW steps.
+		vector<StopReason> chain_reason(this->pop, StopReason::COMPLETED);
+		vector<int> chain_steps(this->pop, 0);
+		pool.parallelFor(this->pop, [this, case_num, pdv_num, use_stop, &deadline, &rngs, &scratch, &chain_reason,
+			&chain_steps](int i, int worker) {
+			StopTracker stopper(this->stop_rule, &deadline);
+			int step = 0, accepted = 0;
+			double temp = this->init_temp;
+			for (; temp > this->min_temp; temp *= this->temp_factor) {
+				bool acc = this->annealStep(i, temp, rngs[i], scratch[worker]);
+				step++;
+				if (this->conv) {
+					accepted += acc;
+					if (step % CONV_SA_WINDOW == 0) {
+						this->reportChain(case_num, i, step, temp, accepted / (double)CONV_SA_WINDOW, pdv_num);
+						accepted = 0;
+					}
+				}
+				if (use_stop && stopper.update(this->tars_met[i][pdv_num], acc, 1)) {
+					temp *= this->temp_factor;
 					break;
 				}
-				trails_met_sum += this->trails_met[j];
 			}
-			if (!can_finish) {
-				this->trails_met.clear();
-				this->trails_met.resize(pdv_num + 1);
+			if (this->conv && step % CONV_SA_WINDOW) {
+				this->reportChain(case_num, i, step, temp / this->temp_factor, accepted / (double)(step % CONV_SA_WINDOW), pdv_num);
 			}
-			this->trails_met[pdv_num] = trails_met_sum;
-
-			double delta_met = (this->trails_met[pdv_num] - this->tars_met[i][pdv_num])*500.;
-			if (delta_met >= 0) {
-				this->tars_idx[i] = this->trails_idx;
-				this->tars_met[i] = this->trails_met;
-				trails_met.clear();
-				trails_met.resize(pdv_num + 1);
+			chain_reason[i] = stopper.getReason();
+			chain_steps[i] = step;
+		});
+
+		//! The run completed if any chain did, otherwise the longest chain tells why it stopped.
+		//! A deadline cuts the whole run short, so it wins over both.
+		int longest = 0;
+		for (int i = 0; i < this->pop; i++) {
+			if (chain_reason[i] == StopReason::COMPLETED) {
+				longest = i;
+				break;
 			}
-			else {
-				if (exp(delta_met / temp) > funcs->getRandFloat()) {
-					this->tars_idx[i] = this->trails_idx;
-					this->tars_met[i] = this->trails_met;
-					this->trails_met.clear();
-					this->trails_met.resize(pdv_num + 1);
+			if (chain_steps[i] > chain_steps[longest]) longest = i;
+		}
+		this->stop_reason = chain_reason[longest];
+		this->steps_run = chain_steps[longest];
+		if (find(chain_reason.begin(), chain_reason.end(), StopReason::DEADLINE) != chain_reason.end()) {
+			this->stop_reason = StopReason::DEADLINE;
+		}
+
+		long long total_steps = 0;
+		for (int s : chain_steps) total_steps += s;
+		this->progress = n_steps > 0 ? total_steps / ((double)this->pop * n_steps) : 1.;
+	}
+	else {
+		//! Replica exchange over the same number of steps as one cooling schedule,
+		//! on a geometric ladder from the hottest (chain 0) to the coldest (last chain) replica
+		vector<double> ladder(this->pop, this->init_temp);
+		for (int i = 1; i < this->pop; i++) {
+			ladder[i] = this->init_temp * pow(this->min_temp / this->init_temp, i / (double)(this->pop - 1));
+		}
+
+		Rng swap_rng(this->used_seed, this->pop);
+		int interval = max(this->swap_interval, 1);
+		vector<int> accepted(this->pop, 0);		//! Steps accepted by each replica in the current round
+		StopTracker stopper(this->stop_rule, &deadline);
+
+		for (int step = 0, round = 0; step < n_steps; step += interval, round++) {
+			int len = min(interval, n_steps - step);
+			pool.parallelFor(this->pop, [this, len, &ladder, &rngs, &scratch, &accepted](int i, int worker) {
+				accepted[i] = 0;
+				for (int k = 0; k < len; k++) accepted[i] += this->annealStep(i, ladder[i], rngs[i], scratch[worker]);
+			});
+
+			if (this->conv) {
+				ConvergenceStream::Sample s = ConvergenceStream::summarise(ConvergenceStream::Alg::SA, case_num, step + len,
+					this->tars_met, pdv_num);
+				int n_acc = 0;
+				for (int a : accepted) n_acc += a;
+				s.accept_rate = n_acc / (double)(this->pop * len);
+				this->conv->push(s);
+			}
+
+			this->steps_run = step + len;
+			if (use_stop) {
+				int n_acc = 0;
+				for (int a : accepted) n_acc += a;
+				double best = this->tars_met[0][pdv_num];
+				for (int i = 1; i < this->pop; i++) best = max(best, this->tars_met[i][pdv_num]);
+				if (stopper.update(best, n_acc, this->pop * len)) {
+					this->stop_reason = stopper.getReason();
+					break;
 				}
 			}
 
-			temp = this->temp_factor * temp;
+			//! Try to swap neighbouring replicas, even and odd pairs in turn
+			SOLVER_PHASE(this->stats, SELECTION);
+			for (int i = round % 2; i + 1 < this->pop; i += 2) {
+				double log_acc = SA_DELTA_SCALE * (this->tars_met[i + 1][pdv_num] - this->tars_met[i][pdv_num])
+					* (1. / ladder[i] - 1. / ladder[i + 1]);
+				if (log_acc >= 0 || exp(log_acc) > swap_rng.uniformDouble()) {
+					swap(this->tars_idx[i], this->tars_idx[i + 1]);
+					swap(this->tars_met[i], this->tars_met[i + 1]);
+				}
+			}
 		}
-
-		temp = this->init_temp;
+		this->progress = n_steps > 0 ? this->steps_run / (double)n_steps : 1.;
 	}
+
 	int best = this->getBestSol(pdv_num);
 
 	auto stop = chrono::high_resolution_clock::now();
-	delete funcs;
 	this->alg_time = chrono::duration_cast<chrono::milliseconds>(stop - start).count();
+	if (SolverStats::enabled()) {
+		for (const EvalScratch& s : scratch) this->stats.merge(s.stats);
+	}
 
 	//this->saveSubPathToCsv(sn_list, this->tars_idx[best]);
 	this->best_sol = this->tars_idx[best];
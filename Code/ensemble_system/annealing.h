@@ -10,10 +10,20 @@
 
 #pragma once
 #include "sensornode.h"
+#include "fitness.h"
+#include "rng.h"
+#include "popstore.h"
+#include "guessgen.h"
+#include "threadpool.h"
+#include "convergence.h"
+#include "stoprule.h"
 
 #ifndef ANNEALING_H_
 #define ANNEALING_H_
 
+//! Scale of the fitness difference in the acceptance probability exp(scale * delta / temp)
+#define SA_DELTA_SCALE 500.
+
 using namespace std;
 
 /*! @class		Annealing annealing.h "annealing.h"
@@ -31,16 +41,22 @@ using namespace std;
 *   @copyright	MIT Public License
 */
 template <class T>
-class Annealing : protected SensorNode<T>
+class Annealing
 {
 public:
 	Point<T>* origin = nullptr;				/*!< The coordiante of BS */
 	vector<vector<vector<int>>> tars_idx;		/*!< Target vector, 3D: pop, pdv and sub path */
-	vector<vector<int>> trails_idx;			/*!< Corresponding trail vector */
+	vector<vector<vector<int>>> trails_idx;		/*!< Trail vector of each chain */
 	vector<vector<double>> tars_met;			/*!< Fitness metric vector of target vector */
-	vector<double> trails_met;				/*!< Fitness metric vector of trail vector */
+	vector<vector<double>> trails_met;			/*!< Fitness metric vector of trail vector of each chain */
 	vector<Point<T>> req_ps;				/*!< @a Point vector of SNs to be recharged */
+	vector<int> req_idx;				/*!< Index of SNs to be recharged */
 	vector<vector<int>> best_sol;
+	FitnessEval<T>* fit_eval = nullptr;		/*!< Fitness engine of the current planning round */
+	PopStore guess_store;				/*!< Mapped initial guesses of the current case */
+	GuessGen<T>* guess_gen = nullptr;		/*!< Initial solution builder of the current planning round */
+	bool load_guess = false;				/*!< Read the initial population from the case store instead of building it */
+	bool save_guess = false;				/*!< Write the built initial population to the case store */
 	
 	double alg_time = 0.;					/*!< Algorithm execution time */
 	int coeff_wsn_eng = 50;
@@ -52,6 +68,19 @@ public:
 	double temp_factor = 0.98;
 	int min_req_num = 20;
 	int max_num_r = 5;
+	size_t dist_budget = DIST_MEM_BUDGET;		/*!< Memory budget of the distance oracle [bytes] */
+	EvalMode eval_mode = EvalMode::GREEDY;		/*!< How sub paths are ordered when scored */
+	uint64_t seed = 0;					/*!< Seed of all random streams, 0 for a time-based seed */
+	uint64_t used_seed = 0;				/*!< Seed actually used by the last run */
+	int n_threads = 0;					/*!< Threads running the chains, 0 for all hardware threads */
+	bool tempering = false;				/*!< Exchange replicas on a fixed temperature ladder instead of cooling */
+	int swap_interval = 10;				/*!< Steps between two replica exchange rounds */
+	SolverStats stats;					/*!< Phase times and event counts of the last run, filled with ODP_SOLVER_STATS */
+	ConvergenceStream* conv = nullptr;			/*!< Receiver of the per-generation progress, nullptr to stream nothing */
+	StopRule stop_rule;					/*!< Early termination rules, all disabled by default */
+	StopReason stop_reason = StopReason::COMPLETED;	/*!< Why the last run stopped */
+	int steps_run = 0;					/*!< Temperature steps (of the longest chain) run by the last run */
+	double progress = 0.;					/*!< Share of the planned steps of all chains run by the last run [0, 1] */
 
 	//! A default constructer with @a origin (0, 0)
 	Annealing();
@@ -66,47 +95,39 @@ public:
 	*/
 	void initParams(vector<SensorNode<T>*>& req_sn_ptr);
 
-	/*! @brief			Save initial guess to csv file.
-	*   @param pop_num	The number of population in generation.
-	*   @param pdv_num	The number of pdv id.
-	*   @param sn_num		The number of SNs.
-	*   @param path_to_save	The path to be saved.
-	*   @tparam T		The type of data to present point coordinates.
-	*/
-	void saveGuessToTxt(int pop_num, int pdv_num, int sn_num, vector<int> path_to_save);
-
-	/*! @brief			Calculate the minimum required number of needed PDVs.
-	*   @param sn_list	A vector of all sensor nodes.
-	*   @param req_sn_ptr	A vector of pointers to all sensor nodes to be recharged.
-	*   @param temp_req_p	A vector of pointers to all @a Point obejects of sensor nodes to be recharged.
+	/*! @brief			Save a whole initial guess population to the binary store of a case.
+	*   @param case_num	The case id.
+	*   @param pop_list	Sub paths of every individual.
 	*   @tparam T		The type of data to present point coordinates.
-	*   @return			The optimised number of needed PDVs.
 	*/
-	int calcOptPdvNum(vector<SensorNode<T>> sn_list, vector<SensorNode<T>*> req_sn_ptr, vector<Point<T>> temp_req_p);
+	void saveGuessData(int case_num, const vector<vector<vector<int>>>& pop_list);
 
-	/*! @brief			Initialize all target and trail vectors randomly with clusters solution from all sensors
+	/*! @brief			Build the whole initial population in memory.
+	*
+	*   Every individual is built by @a guess_gen in its own task and stream, so
+	*   the population does not depend on the thread count. It is written to the
+	*   case store only if @a save_guess is set.
+	*
+	*   @param case_num	The case id.
 	*   @param r_num		The number of shortest point index.
 	*   @param pdv_num	The number of PDVs.
 	*   @param pop_num	The number of total population.
-	*   @param sn_list	A vector of all sensor nodes.
-	*   @param req_sn_ptr	A vector of pointers to all sensor nodes to be recharged.
-	*   @param req_ps		A vector of @a Point objects of all sensor nodes to be recharged.
+	*   @param pool		Workers building the individuals.
 	*   @tparam T		The type of data to present point coordinates.
 	*   @return			If the number of nodes to be recharged can be divided exactly by @a pdv_num, return true.
 	*/
-	bool calcInitGuess(const int& r_num, const int& pdv_num, const int& pop_num, vector<SensorNode<T>> sn_list, vector<SensorNode<T>*> req_sn_ptr, vector<Point<T>> req_ps);
+	bool calcInitGuess(int case_num, const int& r_num, const int& pdv_num, const int& pop_num, ThreadPool& pool);
 
 	/*! @brief		      Calculate the fitness of the possible solution.
 	*
 	*   The criteria is based on the amount of recharged energy and the distance of flight.
 	*   Related formula: Fitness M = alpha * tanh(E_{wsn}) + beta * inv_tanh(d_{pdv}) + gamma * inv_tanh(E_{pdv})
 	*
-	*   @param sn_list	A vector of all sensor nodes.
-	*   @param clst_list	A vector of clusters to be calculated (can be one target or trail vector).
+	*   @param idx_list	A index vector of targets to be calculated.
 	*   @tparam T		The type of data to present point coordinates.
 	*   @return			The fitness metric value.
 	*/
-	double fitnessFunc(vector<SensorNode<T>> sn_list, vector<int> clst_list);
+	double fitnessFunc(const vector<int>& idx_list);
 
 	/*! @brief			Find the index of the best solution with the highest fitness metric value.
 	*   @param pdv_num	The number of PDVs.
@@ -114,12 +135,12 @@ public:
 	*/
 	int getBestSol(const int& pdv_num);
 
-	/*! @brief			Read the data from stored initial guess
+	/*! @brief			Read one sub path from @a guess_store , which must be opened for the current case.
 	*   @param pop_num	The population id.
 	*   @param pdv_num	The PDV id.
 	*   @return			A vector of solution (index of sensor nodes) with @a pop_num and @a pdv_num
 	*/
-	vector<int> readGuessData(int case_num, int pop_num, int pdv_num);
+	vector<int> readGuessData(int pop_num, int pdv_num);
 
 	/*! @brief			Save sub paths with best metric
 	*   @param sn_list	A vector of all sensor nodes.
@@ -131,13 +152,48 @@ public:
 	/*! @brief			Save initial guess to csv file.
 	*   @param cur_pdv	The number of pdv id.
 	*   @param idx_list	The target vector to be re-generated.
-	*   @param req_ps		A vector of @a Point objects to be recharged.
-	*   @param sn_list	A vector of all sensor nodes.
+	*   @param rng		The RNG stream of the calling chain.
+	*   @param dirty		Flags of the sub paths changed by the swap, set but never cleared here.
+	*   @return			The number of swaps made.
 	*   @tparam T		The type of data to present point coordinates.
 	*/
-	void initOneSol(const int& cur_pdv, vector<vector<int>>& idx_list, vector<Point<T>> req_ps, vector<SensorNode<T>> sn_list);
+	int initOneSol(const int& cur_pdv, vector<vector<int>>& idx_list, Rng& rng, vector<bool>& dirty);
+
+	/*! @brief			Run one Metropolis step of a chain.
+	*
+	*   A trail is generated from the chain's target with @a initOneSol for every
+	*   PDV and replaces the target if it is better, or with probability
+	*   exp(SA_DELTA_SCALE * delta / temp) otherwise. The trail starts from the
+	*   target's metrics and only the sub paths changed by the swaps are
+	*   re-scored. Only the rows of @a chain are touched, so different chains
+	*   can step concurrently.
+	*
+	*   @param chain		The chain (population) id.
+	*   @param temp		Current temperature of the chain.
+	*   @param rng		The RNG stream of the chain.
+	*   @param scratch	Working buffers of the calling thread.
+	*   @tparam T		The type of data to present point coordinates.
+	*   @return			If the trail is accepted, return true.
+	*/
+	bool annealStep(int chain, double temp, Rng& rng, EvalScratch& scratch);
+
+	/*! @brief			Push the state of one chain to @a conv .
+	*   @param case_num	The case id.
+	*   @param chain		The chain (population) id.
+	*   @param step		Steps run by the chain so far.
+	*   @param temp		Temperature of the last step.
+	*   @param accept_rate	Steps accepted since the last sample of the chain [0, 1].
+	*   @param pdv_num	The number of PDVs.
+	*/
+	void reportChain(int case_num, int chain, int step, double temp, double accept_rate, int pdv_num);
 
 	/*! @brief			Initialize all target and trail vectors randomly with clusters solution from all sensors
+	*
+	*   The @a pop chains run concurrently, each cooling from @a init_temp to @a min_temp .
+	*   With @a tempering , the chains instead run at a geometric ladder of fixed
+	*   temperatures for the same number of steps and neighbouring replicas try to
+	*   swap states every @a swap_interval steps. The best chain wins in both modes.
+	*
 	*   @param sn_list	A vector of all sensor nodes.
 	*   @param candidates	A vector of pointers to all sensor nodes to be recharged.
 	*   @return			If the number of nodes to be recharged can be divided exactly by @a pdv_num, return true.
@@ -18,6 +18,8 @@
 #include "blackhole.h"
 #include "funcs.h"
 #include "pdv.h"
+#include "pdvestimator.h"
+#include "threadpool.h"
 
 using namespace std;
 
@@ -44,6 +46,8 @@ BlackHole<T>::BlackHole(int w_wsn_eng, int w_pdv_eng, int w_pdv_dist, int n_gen,
 template <class T>
 BlackHole<T>::~BlackHole() {
 	delete this->origin;
+	delete this->fit_eval;
+	delete this->guess_gen;
 }
 
 template <class T>
@@ -64,363 +68,38 @@ void BlackHole<T>::initParams(vector<SensorNode<T>*> req_sn_ptr) {
 	this->tars_metric.resize(this->pop);
 }
 
-template <class T>
-int BlackHole<T>::calcOptPdvNum(vector<SensorNode<T>> sn_list, vector<SensorNode<T>*> req_sn_ptr, vector<Point<T>> temp_req_p) {
-	PDV<T>* temp_pdv = new PDV<T>();
-
-	int pdv_num = 1;
-	do {
-		if (temp_pdv->f_eng <= 20) {
-			pdv_num++;
-			temp_pdv->resetPdvStatus();
-			continue;
-		}
-
-		vector<double> d_list = temp_pdv->pos.calcDist(temp_req_p);
-		int next = distance(d_list.begin(), min_element(d_list.begin(), d_list.end()));
-
-		int this_cn = -1;
-		for (unsigned i = 0; i < sn_list.size(); i++) {
-			if (sn_list[i].pos.isCoincide(req_sn_ptr[next]->pos)) {
-				this_cn = i;
-				break;
-			}
-		}
-
-		double ipt_eng = 0.;
-		temp_pdv->iptEnergyCost(sn_list[this_cn], ipt_eng);
-
-		if (temp_pdv->calcEnergyCost(temp_req_p[next].calcDist(Point<T>()) / temp_pdv->getPdvSpeed())
-			+ temp_pdv->calcEnergyCost(temp_pdv->pos.calcDist(temp_req_p[next]) / temp_pdv->getPdvSpeed())
-			+ ipt_eng + 20 > temp_pdv->f_eng) {
-
-			pdv_num++;
-			temp_pdv->resetPdvStatus();
-			continue;
-		}
-
-		temp_pdv->updatePdvStatus(temp_req_p[next]);
-		temp_pdv->f_eng -= ipt_eng;
-
-		temp_req_p.erase(temp_req_p.begin() + next);
-		req_sn_ptr.erase(req_sn_ptr.begin() + next);
-	} while (temp_req_p.size());
-
-	delete temp_pdv;
-	return pdv_num;
-}
 
 template <class T>
-void BlackHole<T>::saveGuessToTxt(int pop_num, int pdv_num_txt, int sn_num, vector<int> path_to_save) {
-	string fname = "../input/initial_guess/pop" + to_string(pop_num)
-		+ "_pdv" + to_string(pdv_num_txt) + ".txt";
-
-	fstream file;
-	try {
-		file.open(fname, fstream::out);
-		if (!file.is_open())
-			throw runtime_error(strerror(errno));
-	}
-	catch (const exception& e) {
-		cerr << e.what() << "\n";
-	}
-
-	for (int i = 0; i < sn_num; i++) {
-		file << path_to_save[i];
-		if (i == sn_num - 1) {
-			file << endl;
-			break;
-		}
-		file << ",";
-	}
-
-	file.close();
+void BlackHole<T>::saveGuessData(int case_num, const vector<vector<vector<int>>>& pop_list) {
+	PopStore::save(PopStore::casePath(case_num), pop_list);
 }
 
 template <class T>
-bool BlackHole<T>::calcInitGuess(const int& r_num, const int& pdv_num, const int& pop_num, 
-		vector<SensorNode<T>> sn_list, vector<SensorNode<T>*> req_sn_ptr, vector<Point<T>> req_ps) {
-	int len = req_sn_ptr.size();
-	int len_sub_path = len / pdv_num;
-	bool is_match = true;
-	if (len % pdv_num != 0) is_match = false;
-
-	vector<Point<T>> temp_req_p = req_ps;
-	auto* funcs = new Funcs<double>();
-
-	for (int i = 0; i < pop_num; i++) {
-		//! The sub vector of @a clsts_list
-		vector<int> req_sn_list;
-		req_sn_list.reserve(len_sub_path);
-		Point<T>* temp_p = new Point<T>();
-		for (int j = 0; j < pdv_num; j++) {
-
-			//! If not divisible, the last PDV assignment should be different
-			if (j == pdv_num - 1 && !is_match) {
-				break;
-			}
+bool BlackHole<T>::calcInitGuess(int case_num, const int& r_num, const int& pdv_num, const int& pop_num, ThreadPool& pool) {
+	uint64_t run_seed = this->used_seed;
+	pool.parallelFor(pop_num, [this, r_num, pdv_num, run_seed](int i, int /*worker*/) {
+		Rng rng = GuessGen<T>::memberRng(run_seed, i);
+		this->guess_gen->buildOne(r_num, pdv_num, rng, this->tars_idx[i]);
+	});
 
-			for (int k = 0; k < len_sub_path; k++) {
-				//! Find the index randomly (the `num`th shortest)
-				vector<double> d_list = temp_p->calcDist(temp_req_p);
-				int num = 0;
-				int temp_size = temp_req_p.size();
-				if (temp_size > r_num) num = funcs->getRandIndex(r_num - 1);
-				else num = funcs->getRandIndex(temp_size - 1);
-
-				unique_ptr<vector<double>> sort_ds = make_unique<vector<double>>(num + 1);
-				partial_sort_copy(d_list.begin(), d_list.end(), sort_ds->begin(), sort_ds->end());
-				auto it = find(d_list.begin(), d_list.end(), (*sort_ds)[num]);
-				int next = distance(d_list.begin(), it);
-
-				int sn_idx = -1;
-				for (unsigned z = 0; z < sn_list.size(); z++) {
-					if (sn_list[z].pos.isCoincide(temp_req_p[next])) {
-						sn_idx = z;
-						break;
-					}
-				}
+	if (this->save_guess) this->saveGuessData(case_num, this->tars_idx);
 
-				req_sn_list.push_back(sn_idx);
-				temp_req_p.erase(temp_req_p.begin() + next);
-			}
-
-			this->saveGuessToTxt(i, j, req_sn_list.size(), req_sn_list);
-			req_sn_list.clear();
-			temp_p->setX(0.);
-			temp_p->setY(0.);
-		}
-
-		if (!is_match) {
-			do {
-				//! Find the index randomly (the `num`th shortest)
-				vector<double> d_list = temp_p->calcDist(temp_req_p);
-				int num = 0;
-				int temp_size = temp_req_p.size();
-				if (temp_size > r_num) num = funcs->getRandIndex(r_num - 1);
-				else num = funcs->getRandIndex(temp_size - 1);
-
-				unique_ptr<vector<double>> sort_ds = make_unique<vector<double>>(num + 1);
-				partial_sort_copy(d_list.begin(), d_list.end(), sort_ds->begin(), sort_ds->end());
-				auto it = find(d_list.begin(), d_list.end(), (*sort_ds)[num]);
-				int next = distance(d_list.begin(), it);
-
-				int sn_idx = -1;
-				for (unsigned z = 0; z < sn_list.size(); z++) {
-					if (sn_list[z].pos.isCoincide(temp_req_p[next])) {
-						sn_idx = z;
-						break;
-					}
-				}
-
-				req_sn_list.push_back(sn_idx);
-				temp_req_p.erase(temp_req_p.begin() + next);
-			} while (temp_req_p.size());
-
-			this->saveGuessToTxt(i, pdv_num - 1, req_sn_list.size(), req_sn_list);
-			req_sn_list.clear();
-			temp_p->setX(0.);
-			temp_p->setY(0.);
-		}
-
-		//! Re-initialize @a temp_req_p for each population
-		temp_req_p = req_ps;
-		delete temp_p;
-	}
-	delete funcs;
-	return is_match;
+	return this->guess_gen->isMatch(pdv_num);
 }
 
 template <class T>
-void BlackHole<T>::initOneSol(const int& pdv_num, vector<vector<int>>& idx_list, vector<Point<T>> req_ps,
-		vector<SensorNode<T>> sn_list, vector<SensorNode<T>*> req_sn_ptr) {
-	if (idx_list.size()) {
-		for (int i = 0; i < pdv_num; i++) {
-			idx_list[i].clear();
-		}
-	}
-	idx_list.resize(pdv_num);
-
-	int len = req_sn_ptr.size();
-	int len_sub_path = len / pdv_num;
-	bool is_match = true;
-	if (len % pdv_num != 0) is_match = false;
-
-	vector<Point<T>> temp_req_p = req_ps;
-	vector<int> req_sn_list;
-	req_sn_list.reserve(len_sub_path);
-	Point<T>* temp_p = new Point<T>();
-
-	auto* funcs = new Funcs<double>();
-
-	for (int j = 0; j < pdv_num; j++) {
-		//! If not divisible, the last PDV assignment should be different
-		if (j == pdv_num - 1 && !is_match) {
-			break;
-		}
-
-		for (int k = 0; k < len_sub_path; k++) {
-			//! Find the index randomly (the `num`th shortest)
-			vector<double> d_list = temp_p->calcDist(temp_req_p);
-			int num = 0;
-			int temp_size = temp_req_p.size();
-			if (temp_size > this->max_num_r) num = funcs->getRandIndex(this->max_num_r - 1);
-			else num = funcs->getRandIndex(temp_size - 1);
-
-			unique_ptr<vector<double>> sort_ds = make_unique<vector<double>>(num + 1);
-			partial_sort_copy(d_list.begin(), d_list.end(), sort_ds->begin(), sort_ds->end());
-			auto it = find(d_list.begin(), d_list.end(), (*sort_ds)[num]);
-			int next = distance(d_list.begin(), it);
-
-			int sn_idx = -1;
-			for (unsigned z = 0; z < sn_list.size(); z++) {
-				if (sn_list[z].pos.isCoincide(temp_req_p[next])) {
-					sn_idx = z;
-					break;
-				}
-			}
-
-			req_sn_list.push_back(sn_idx);
-			temp_req_p.erase(temp_req_p.begin() + next);
-		}
-
-		idx_list[j] = req_sn_list;
-
-		req_sn_list.clear();
-		temp_p->setX(0.);
-		temp_p->setY(0.);
-	}
-
-	if (!is_match) {
-		do {
-			//! Find the index randomly (the `num`th shortest)
-			vector<double> d_list = temp_p->calcDist(temp_req_p);
-			int num = 0;
-			int temp_size = temp_req_p.size();
-			if (temp_size > this->max_num_r) num = funcs->getRandIndex(this->max_num_r - 1);
-			else num = funcs->getRandIndex(temp_size - 1);
-
-			unique_ptr<vector<double>> sort_ds = make_unique<vector<double>>(num + 1);
-			partial_sort_copy(d_list.begin(), d_list.end(), sort_ds->begin(), sort_ds->end());
-			auto it = find(d_list.begin(), d_list.end(), (*sort_ds)[num]);
-			int next = distance(d_list.begin(), it);
-
-			int sn_idx = -1;
-			for (unsigned z = 0; z < sn_list.size(); z++) {
-				if (sn_list[z].pos.isCoincide(temp_req_p[next])) {
-					sn_idx = z;
-					break;
-				}
-			}
-
-			req_sn_list.push_back(sn_idx);
-			temp_req_p.erase(temp_req_p.begin() + next);
-		} while (temp_req_p.size());
-
-		idx_list[pdv_num - 1] = req_sn_list;
-		req_sn_list.clear();
-		temp_p->setX(0.);
-		temp_p->setY(0.);
-	}
-
-	delete temp_p;
-	delete funcs;
+void BlackHole<T>::initOneSol(const int& pdv_num, vector<vector<int>>& idx_list, Rng& rng) {
+	this->guess_gen->buildOne(this->max_num_r, pdv_num, rng, idx_list);
 }
 
 template <class T>
-double BlackHole<T>::fitnessFunc(vector<SensorNode<T>> sn_list, vector<int> idx_list) {
-	vector<Point<T>> this_flight_path;
-	this_flight_path.reserve(idx_list.size());
-	for (unsigned i = 0; i < idx_list.size(); i++) {
-		this_flight_path.push_back(sn_list[idx_list[i]].pos);
-	}
-
-	unique_ptr<PDV<T>> pdv = make_unique<PDV<T>>();
-	double charged_eng = 0., total_eng = 0.;
-
-	do {
-		vector<double> d_list = pdv->pos.calcDist(this_flight_path);
-		int next = distance(d_list.begin(), min_element(d_list.begin(), d_list.end()));
-
-		//! Implement inductive power transfer to the center node.
-		int this_cn = -1;
-		for (unsigned i = 0; i < sn_list.size(); i++) {
-			if (sn_list[i].pos.isCoincide(this_flight_path[next])) {
-				this_cn = i;
-				break;
-			}
-		}
-
-		if (pdv->calcEnergyCost(this_flight_path[next].calcDist(Point<T>()) / pdv->getPdvSpeed()) + 
-			pdv->calcEnergyCost(pdv->pos.calcDist(this_flight_path[next]) / pdv->getPdvSpeed()) > pdv->f_eng) {
-			return -1000.;
-		}
-
-		pdv->updatePdvStatus(this_flight_path[next]);
-
-		//! Update IPT energy cost
-		double ipt_eng = 0.;
-		pdv->iptEnergyCost(sn_list[this_cn], ipt_eng);
-		pdv->f_eng -= ipt_eng;
-		charged_eng += sn_list[this_cn].calcPackage() - 12.;
-		total_eng += sn_list[this_cn].calcMaxEnergy();
-
-		unique_ptr<Cluster<T>> clst = make_unique<Cluster<T>>();
-		clst->center = &sn_list[this_cn].pos;
-		clst->contains.clear();
-		clst->contains.push_back(&sn_list[this_cn]);
-		clst->assignEndNodes(sn_list);
-
-		//! Implement center node acoustic power trannsfer.
-		for (unsigned i = 1; i < clst->contains.size(); i++) {
-			auto this_sn = clst->contains[i] - &sn_list[0];
-			double temp_d = 0., temp_g = 0.;
-			temp_d = sn_list[this_sn].pos.calcDist(*clst->center);
-			temp_g = exp(-1. * pow(2 * PI * 47500, EFF_ACOUS) * temp_d * ALPHA_MAT);
-			charged_eng += EFF_PIEZO * EFF_PIEZO * EFF_ACOUS2DC * temp_g * ACOUS_ENERGY_SEND;
-		}
-
-		this_flight_path.erase(this_flight_path.begin() + next);
-	} while (this_flight_path.size());
-
-	//! Return to home process
-	pdv->updatePdvStatus(Point<T>());
-
-	auto* funcs = new Funcs<double>();
-
-	double wsn_e_fac = this->coeff_wsn_eng * funcs->tanhFunc(charged_eng / (total_eng * 0.9));		//! Wh
-	double pdv_e_fac = this->coeff_pdv_eng * funcs->invTanhFunc((187. - pdv->f_eng) / 187.);			//! Wh
-
-	double fitness = wsn_e_fac + pdv_e_fac;
-	delete funcs;
-	return fitness;
+double BlackHole<T>::fitnessFunc(const vector<int>& idx_list) {
+	return this->fit_eval->calcFitness(idx_list);
 }
 
 template <class T>
-vector<int> BlackHole<T>::readGuessData(int case_num, int pop_num, int pdv_num) {
-	string fname = "../input/initial_guess/case" + to_string(case_num) + "/pop" + to_string(pop_num) + "pdv" + to_string(pdv_num) + ".txt";
-	vector<int> idx_list;
-	fstream file;
-	try {
-		file.open(fname, fstream::in);
-		if (!file.is_open()) throw runtime_error(strerror(errno));
-	}
-	catch (const std::exception& e) {
-		cerr << e.what() << "\n";
-	}
-
-	string line;
-	if (file.good()) getline(file, line);
-	file.close();
-
-	stringstream ss(line);
-	idx_list.clear();
-	for (int i; ss >> i;) {
-		idx_list.push_back(i);
-		if (ss.peek() == ',') ss.ignore();
-	}
-
-	return idx_list;
+vector<int> BlackHole<T>::readGuessData(int pop_num, int pdv_num) {
+	return this->guess_store.readPath(pop_num, pdv_num);
 }
 
 template <class T>
@@ -448,33 +127,28 @@ void BlackHole<T>::saveSubPathToCsv(vector<SensorNode<T>> sn_list, vector<vector
 }
 
 template <class T>
-void BlackHole<T>::attraction(int cur_gen, int cur_pdv, const int& bh_num,
-		vector<SensorNode<T>> sn_list, vector<Point<T>> req_ps, vector<vector<int>>& tar_vec) {
+int BlackHole<T>::attraction(int cur_gen, int cur_pdv, const int& bh_num, vector<vector<int>>& tar_vec, Rng& rng, vector<bool>& dirty) {
+	const SensorFleet<T>& fleet = this->fit_eval->getFleet();
+	const DistOracle<T>& oracle = this->fit_eval->getOracle();
+	int n_swap = 0;
 	double delta_x = 0.;
 	double delta_y = 0.;
 	double rand_fac = 0.;
-	auto* funcs = new Funcs<double>();
 	for (unsigned z = 0; z < tar_vec[cur_pdv].size(); z++) {
-		if (funcs->getRandIndex(100) <= this->ar) continue;
+		if (rng.uniformInt(100) <= this->ar) continue;
 
 		// if current solution (of current PDV) doesn't have same size as bh solution (of current PDV)
 		if (z >= this->tars_idx[bh_num][cur_pdv].size()) {
-			if (funcs->getRandIndex(100) <= this->ar) break;
-			vector<double> d_list = sn_list[tar_vec[cur_pdv][z]].pos.calcDist(req_ps);
-			int next = distance(d_list.begin(), min_element(d_list.begin(), d_list.end()));
-
-			for (unsigned m = 0; m < sn_list.size(); m++) {
-				if (req_ps[next].isCoincide(sn_list[m].pos)) {
-					next = m;
-					break;
-				}
-			}
+			if (rng.uniformInt(100) <= this->ar) break;
+			int next = this->req_idx[oracle.nearestTo(fleet.xs[tar_vec[cur_pdv][z]], fleet.ys[tar_vec[cur_pdv][z]])];
 
 			for (unsigned m = 0; m < tar_vec.size(); m++) {
 				for (unsigned n = 0; n < tar_vec[m].size(); n++) {
 					if (m == cur_pdv && n == z) continue;
 					if (tar_vec[m][n] == next) {
 						swap(tar_vec[cur_pdv][z], tar_vec[m][n]);
+						n_swap++;
+						if (this->fit_eval->swapChangesScore((int)m == cur_pdv)) dirty[cur_pdv] = dirty[m] = true;
 					}
 				}
 			}
@@ -482,107 +156,177 @@ void BlackHole<T>::attraction(int cur_gen, int cur_pdv, const int& bh_num,
 			break;
 		}
 
-		rand_fac = funcs->getRandFloat();
-		delta_x = rand_fac * (sn_list[tar_vec[cur_pdv][z]].pos.getX() - sn_list[this->tars_idx[bh_num][cur_pdv][z]].pos.getX());
-		delta_y = rand_fac * (sn_list[tar_vec[cur_pdv][z]].pos.getY() - sn_list[this->tars_idx[bh_num][cur_pdv][z]].pos.getY());
-		unique_ptr<Point<T>> temp_p = make_unique<Point<T>>(sn_list[tar_vec[cur_pdv][z]].pos.getX() + delta_x, 
-			sn_list[tar_vec[cur_pdv][z]].pos.getY() + delta_y);
-		vector<double> d_list = temp_p->calcDist(req_ps);
-		int next = distance(d_list.begin(), min_element(d_list.begin(), d_list.end()));
-		for (unsigned m = 0; m < sn_list.size(); m++) {
-			if (req_ps[next].isCoincide(sn_list[m].pos)) {
-				next = m;
-				break;
-			}
-		}
+		rand_fac = rng.uniformFloat();
+		delta_x = rand_fac * (fleet.xs[tar_vec[cur_pdv][z]] - fleet.xs[this->tars_idx[bh_num][cur_pdv][z]]);
+		delta_y = rand_fac * (fleet.ys[tar_vec[cur_pdv][z]] - fleet.ys[this->tars_idx[bh_num][cur_pdv][z]]);
+		int next = this->req_idx[oracle.nearestTo(fleet.xs[tar_vec[cur_pdv][z]] + delta_x,
+			fleet.ys[tar_vec[cur_pdv][z]] + delta_y)];
 
 		for (unsigned m = 0; m < tar_vec.size(); m++) {
 			for (unsigned n = 0; n < tar_vec[m].size(); n++) {
 				if (m == cur_pdv && n == z) continue;
 				if (tar_vec[m][n] == next) {
 					swap(tar_vec[cur_pdv][z], tar_vec[m][n]);
+					n_swap++;
+					if (this->fit_eval->swapChangesScore((int)m == cur_pdv)) dirty[cur_pdv] = dirty[m] = true;
 				}
 			}
 		}
 	}
-	delete funcs;
+
+	return n_swap;
 }
 
 template <class T>
-void BlackHole<T>::calcFinalPath(int case_num, vector<SensorNode<T>> sn_list, vector<SensorNode<T>*> candidates) {
+void BlackHole<T>::calcFinalPath(int case_num, vector<SensorNode<T>>& sn_list, vector<SensorNode<T>*> candidates) {
 	//bool is_match = false;
-	int pdv_num = this->calcOptPdvNum(sn_list, candidates, this->req_ps);
-	//is_match = this->calcInitGuess(this->max_num_r, pdv_num, this->pop, sn_list, candidates, this->req_ps);
+	//! The budget covers the whole call, the fitness tables included.
+	Deadline deadline(this->stop_rule.time_budget);
+	this->req_idx.resize(candidates.size());
+	for (unsigned i = 0; i < candidates.size(); i++) this->req_idx[i] = candidates[i] - &sn_list[0];
+
+	delete this->fit_eval;
+	this->fit_eval = new FitnessEval<T>(sn_list, this->req_idx, this->coeff_wsn_eng, this->coeff_pdv_eng, this->eval_mode,
+		this->dist_budget);
+	delete this->guess_gen;
+	this->guess_gen = new GuessGen<T>(this->fit_eval->getOracle(), this->req_idx);
+	this->used_seed = this->seed ? this->seed : Rng::timeSeed();
+	this->rng.seed(this->used_seed);
+
+	int pdv_num = PdvEstimator<T>::estimate(*this->fit_eval);
 	
 
-	auto* funcs = new Funcs<double>();
+	ThreadPool pool(this->n_threads);
+	vector<EvalScratch> scratch(pool.getThreadNum());
+	this->stats.reset();
+
 	auto start = chrono::high_resolution_clock::now();
 
 	//! Initialization
-	for (int i = 0; i < this->pop; i++) {
-		this->tars_idx[i].resize(pdv_num);
-		this->tars_metric[i].resize(pdv_num + 1);
+	{
+		SOLVER_PHASE(this->stats, LOAD);
+		bool loaded = this->load_guess
+			&& this->guess_gen->loadCase(this->guess_store, case_num, this->pop, pdv_num, this->tars_idx);
+		if (!loaded) {
+			this->calcInitGuess(case_num, this->max_num_r, pdv_num, this->pop, pool);
+			SOLVER_COUNT(this->stats, CLUSTER_BUILDS, this->pop * pdv_num);
+		}
+	}
 
+	pool.parallelFor(this->pop, [this, pdv_num, &scratch](int i, int worker) {
+		SOLVER_PHASE(scratch[worker].stats, INIT_SCORE);
+		this->tars_metric[i].resize(pdv_num + 1);
 		double tar_met_sum = 0.;
 		for (int j = 0; j < pdv_num; j++) {
-			this->tars_idx[i][j] = this->readGuessData(case_num, i, j);
-			this->tars_metric[i][j] = this->fitnessFunc(sn_list, this->tars_idx[i][j]);
+			this->tars_metric[i][j] = this->fit_eval->calcFitness(this->tars_idx[i][j], scratch[worker]);
 			tar_met_sum += this->tars_metric[i][j];
 		}
 		this->tars_metric[i][pdv_num] = tar_met_sum;
-	}
+	});
 
 	int bh_idx = 0;
 	for (int i = 1; i < this->pop; i++) {
 		if (this->tars_metric[i][pdv_num] > this->tars_metric[bh_idx][pdv_num]) bh_idx = i;
 	}
 
+	//! Stars only touch their own rows and draw from a stream derived from (seed, generation, star, phase),
+	//! so the result does not depend on the thread count.
+	uint64_t run_seed = this->used_seed;
+	auto starRng = [run_seed](int gen_id, int star, int phase) {
+		return Rng(run_seed, Rng::streamId(Rng::streamId(gen_id, star), phase));
+	};
+
+	vector<char> swallowed(this->pop, 0);		//! If a star was re-initialised in this generation
+	auto report = [this, case_num, pdv_num, &swallowed](int gen_id) {
+		ConvergenceStream::Sample s = ConvergenceStream::summarise(ConvergenceStream::Alg::BH, case_num, gen_id,
+			this->tars_metric, pdv_num);
+		s.replaced = static_cast<int32_t>(count(swallowed.begin(), swallowed.end(), 1));
+		this->conv->push(s);
+	};
+
+	StopTracker stopper(this->stop_rule, &deadline);
+	this->steps_run = 0;
 	for (int i = 0; i < this->gen; i++) {
 		double sum_fitness = 0., bh_r = 0.;
-		for (int j = 0; j < this->pop; j++) {
-			// @a sum_fitness includes the fitness metric of BH
-			if (j == bh_idx) {
-				sum_fitness += this->tars_metric[j][pdv_num];
-				continue;			//! Black hole
+
+		pool.parallelFor(this->pop, [this, i, pdv_num, bh_idx, &starRng, &scratch](int j, int worker) {
+			if (j == bh_idx) return;			//! Black hole
+
+			//! Swaps may also change sub paths attracted earlier, so all moves are made before re-scoring
+			//! and only the changed sub paths are evaluated again.
+			Rng rng = starRng(i, j, 0);
+			vector<bool> dirty(pdv_num, false);
+			{
+				SOLVER_PHASE(scratch[worker].stats, MOVES);
+				int n_swap = 0;
+				for (int k = 0; k < pdv_num; k++) n_swap += this->attraction(j, k, bh_idx, this->tars_idx[j], rng, dirty);
+				SOLVER_COUNT(scratch[worker].stats, SWAPS, n_swap);
+				SOLVER_COUNT(scratch[worker].stats, ACCEPTED, n_swap > 0);
 			}
 
-			double new_tar_sum = 0.;
+			SOLVER_PHASE(scratch[worker].stats, EVAL);
+			double new_tar_sum = this->tars_metric[j][pdv_num];
 			for (int k = 0; k < pdv_num; k++) {
-				this->attraction(j, k, bh_idx, sn_list, this->req_ps, this->tars_idx[j]); 
-				this->tars_metric[j][k] = this->fitnessFunc(sn_list, this->tars_idx[j][k]);
-				new_tar_sum += this->tars_metric[j][k];
+				if (!dirty[k]) continue;
+				double met = this->fit_eval->calcFitness(this->tars_idx[j][k], scratch[worker]);
+				new_tar_sum += met - this->tars_metric[j][k];
+				this->tars_metric[j][k] = met;
 			}
 			this->tars_metric[j][pdv_num] = new_tar_sum;
-			sum_fitness += new_tar_sum;
-		}
+		});
 
-		bh_idx = 0;
-		for (int i = 1; i < this->pop; i++) {
-			if (this->tars_metric[i][pdv_num] > this->tars_metric[bh_idx][pdv_num]) bh_idx = i;
+		{
+			SOLVER_PHASE(this->stats, SELECTION);
+			// @a sum_fitness includes the fitness metric of BH
+			for (int j = 0; j < this->pop; j++) sum_fitness += this->tars_metric[j][pdv_num];
+
+			bh_idx = 0;
+			for (int i = 1; i < this->pop; i++) {
+				if (this->tars_metric[i][pdv_num] > this->tars_metric[bh_idx][pdv_num]) bh_idx = i;
+			}
 		}
 
-		if (i == this->gen - 1) break;
+		swallowed.assign(this->pop, 0);
+		this->steps_run = i + 1;
+		bool stopped = this->stop_rule.isEnabled() && stopper.update(this->tars_metric[bh_idx][pdv_num]);
+		if (i == this->gen - 1 || stopped) {
+			if (this->conv) report(i);
+			break;
+		}
 
 		bh_r = this->tars_metric[bh_idx][pdv_num] / sum_fitness;
-		for (int j = 0; j < this->pop; j++) {
-			if (j == bh_idx) continue;
-
-			if (funcs->getRandFloat() < bh_r) {
-				this->initOneSol(pdv_num, this->tars_idx[j], this->req_ps, sn_list, candidates);
+		pool.parallelFor(this->pop, [this, i, pdv_num, bh_idx, bh_r, &starRng, &scratch, &swallowed](int j, int worker) {
+			if (j == bh_idx) return;
+
+			Rng rng = starRng(i, j, 1);
+			if (rng.uniformFloat() < bh_r) {
+				swallowed[j] = 1;
+				{
+					SOLVER_PHASE(scratch[worker].stats, MOVES);
+					this->initOneSol(pdv_num, this->tars_idx[j], rng);
+					SOLVER_COUNT(scratch[worker].stats, CLUSTER_BUILDS, pdv_num);
+				}
 
+				SOLVER_PHASE(scratch[worker].stats, EVAL);
 				double new_sol_met_sum = 0.;
 				for (int k = 0; k < pdv_num; k++) {
-					this->tars_metric[j][k] = this->fitnessFunc(sn_list, this->tars_idx[j][k]);
+					this->tars_metric[j][k] = this->fit_eval->calcFitness(this->tars_idx[j][k], scratch[worker]);
 					new_sol_met_sum += this->tars_metric[j][k];
 				}
 				this->tars_metric[j][pdv_num] = new_sol_met_sum;
 			}
-		}
+		});
+		if (this->conv) report(i);
 	}
 
+	this->stop_reason = stopper.getReason();
+	this->progress = this->gen > 0 ? this->steps_run / (double)this->gen : 1.;
+
 	auto stop = chrono::high_resolution_clock::now();
 	this->alg_time = chrono::duration_cast<chrono::milliseconds>(stop - start).count();
-	delete funcs;
+	if (SolverStats::enabled()) {
+		for (const EvalScratch& s : scratch) this->stats.merge(s.stats);
+	}
 
 	//this->saveSubPathToCsv(sn_list, this->tars_idx[bh_idx]);
 	this->best_sol = this->tars_idx[bh_idx];
@@ -10,6 +10,13 @@
 
 #pragma once
 #include "sensornode.h"
+#include "fitness.h"
+#include "rng.h"
+#include "popstore.h"
+#include "guessgen.h"
+#include "threadpool.h"
+#include "convergence.h"
+#include "stoprule.h"
 
 #ifndef BLACKHOLE_H_
 #define BLACKHOLE_H_
@@ -31,14 +38,20 @@ using namespace std;
 *   @copyright	MIT Public License
 */
 template <class T>
-class BlackHole : protected SensorNode<T>
+class BlackHole
 {
 public:
 	Point<T>* origin = nullptr;			/*!< The coordiante of BS */
 	vector<vector<vector<int>>> tars_idx;	/*!< Target vector of index, 3D: pop, pdv and sub path */
 	vector<vector<double>> tars_metric;		/*!< Corresponding trail vector */
 	vector<Point<T>> req_ps;			/*!< @a Point vector of SNs to be recharged */
+	vector<int> req_idx;				/*!< Index of SNs to be recharged */
 	vector<vector<int>> best_sol;
+	FitnessEval<T>* fit_eval = nullptr;		/*!< Fitness engine of the current planning round */
+	PopStore guess_store;				/*!< Mapped initial guesses of the current case */
+	GuessGen<T>* guess_gen = nullptr;		/*!< Initial solution builder of the current planning round */
+	bool load_guess = false;				/*!< Read the initial population from the case store instead of building it */
+	bool save_guess = false;				/*!< Write the built initial population to the case store */
 	
 	double alg_time = 0.;				/*!< Algorithm execution time */
 	int coeff_wsn_eng = 50;
@@ -49,6 +62,18 @@ public:
 	int ar = 50;
 	int min_req_num = 20;
 	int max_num_r = 5;
+	size_t dist_budget = DIST_MEM_BUDGET;		/*!< Memory budget of the distance oracle [bytes] */
+	EvalMode eval_mode = EvalMode::GREEDY;		/*!< How sub paths are ordered when scored */
+	uint64_t seed = 0;					/*!< Seed of all random streams, 0 for a time-based seed */
+	uint64_t used_seed = 0;				/*!< Seed actually used by the last run */
+	Rng rng;						/*!< Main random stream of a run */
+	int n_threads = 0;					/*!< Threads updating the stars, 0 for all hardware threads */
+	SolverStats stats;					/*!< Phase times and event counts of the last run, filled with ODP_SOLVER_STATS */
+	ConvergenceStream* conv = nullptr;			/*!< Receiver of the per-generation progress, nullptr to stream nothing */
+	StopRule stop_rule;					/*!< Early termination rules, all disabled by default */
+	StopReason stop_reason = StopReason::COMPLETED;	/*!< Why the last run stopped */
+	int steps_run = 0;					/*!< Generations run by the last run */
+	double progress = 0.;					/*!< Share of the planned generations run by the last run [0, 1] */
 
 	//! A default constructer with @a origin (0, 0)
 	BlackHole();
@@ -66,61 +91,51 @@ public:
 	/*! @brief			According to current target vector, re-generate a new one.
 	*   @param pdv_num	The number of PDVs.
 	*   @param idx_list	The target vector at specific PDV id.
-	*   @param req_ps		A vector of @a Point objects to be recharged.
-	*   @param sn_list	A vector of all sensor nodes.
-	*   @param req_sn_ptr   A vector of pointer to @a SensorNode objects to be recharged.
+	*   @param rng		The RNG stream of the star.
 	*   @tparam T		The type of data to present point coordinates.
 	*/
-	void initOneSol(const int& pdv_num, vector<vector<int>>& idx_list, vector<Point<T>> req_ps, vector<SensorNode<T>> sn_list, vector<SensorNode<T>*> req_sn_ptr);
+	void initOneSol(const int& pdv_num, vector<vector<int>>& idx_list, Rng& rng);
 	
-	/*! @brief			Save initial guess to csv file.
-	*   @param pop_num	The number of population in generation.
-	*   @param pdv_num_txt	The number of pdv id.
-	*   @param sn_num		The number of SNs.
-	*   @param path_to_save	The path to be saved.
+	/*! @brief			Save a whole initial guess population to the binary store of a case.
+	*   @param case_num	The case id.
+	*   @param pop_list	Sub paths of every individual.
 	*   @tparam T		The type of data to present point coordinates.
 	*/
-	void saveGuessToTxt(int pop_num, int pdv_num_txt, int sn_num, vector<int> path_to_save);
+	void saveGuessData(int case_num, const vector<vector<vector<int>>>& pop_list);
 
-	/*! @brief			Calculate the minimum required number of needed PDVs.
-	*   @param sn_list	A vector of all sensor nodes.
-	*   @param req_sn_ptr	A vector of pointers to all sensor nodes to be recharged.
-	*   @param temp_req_p	A vector of pointers to all @a Point obejects of sensor nodes to be recharged.
-	*   @tparam T		The type of data to present point coordinates.
-	*   @return			The optimised number of needed PDVs.
-	*/
-	int calcOptPdvNum(vector<SensorNode<T>> sn_list, vector<SensorNode<T>*> req_sn_ptr, vector<Point<T>> temp_req_p);
-	
-	/*! @brief			Initialize all target and trail vectors randomly with clusters solution from all sensors
+	/*! @brief			Build the whole initial population in memory.
+	*
+	*   Every individual is built by @a guess_gen in its own task and stream, so
+	*   the population does not depend on the thread count. It is written to the
+	*   case store only if @a save_guess is set.
+	*
+	*   @param case_num	The case id.
 	*   @param r_num		The number of shortest point index.
 	*   @param pdv_num	The number of PDVs.
 	*   @param pop_num	The number of total population.
-	*   @param sn_list	A vector of all sensor nodes.
-	*   @param req_sn_ptr	A vector of pointers to all sensor nodes to be recharged.
-	*   @param req_ps		A vector of @a Point objects of all sensor nodes to be recharged.
+	*   @param pool		Workers building the individuals.
 	*   @tparam T		The type of data to present point coordinates.
 	*   @return			If the number of nodes to be recharged can be divided exactly by @a pdv_num, return true.
 	*/
-	bool calcInitGuess(const int& r_num, const int& pdv_num, const int& pop_num, vector<SensorNode<T>> sn_list, vector<SensorNode<T>*> req_sn_ptr, vector<Point<T>> req_ps);
+	bool calcInitGuess(int case_num, const int& r_num, const int& pdv_num, const int& pop_num, ThreadPool& pool);
 	
 	/*! @brief		      Calculate the fitness of the possible solution.
 	*
 	*   The criteria is based on the amount of recharged energy and the distance of flight.
 	*   Related formula: Fitness M = alpha * tanh(E_{wsn}) + beta * inv_tanh(d_{pdv}) + gamma * inv_tanh(E_{pdv})
 	*
-	*   @param sn_list	A vector of all sensor nodes.
 	*   @param idx_list	A index vector of targets to be calculated.
 	*   @tparam T		The type of data to present point coordinates.
 	*   @return			The fitness metric value.
 	*/
-	double fitnessFunc(vector<SensorNode<T>> sn_list, vector<int> idx_list);
+	double fitnessFunc(const vector<int>& idx_list);
 	
-	/*! @brief			Read the data from stored initial guess
+	/*! @brief			Read one sub path from @a guess_store , which must be opened for the current case.
 	*   @param pop_num	The population id.
 	*   @param pdv_num	The PDV id.
 	*   @return			A vector of solution (index of sensor nodes) with @a pop_num and @a pdv_num
 	*/
-	vector<int> readGuessData(int case_num, int pop_num, int pdv_num);
+	vector<int> readGuessData(int pop_num, int pdv_num);
 	
 	/*! @brief			Save sub paths with best metric
 	*   @param sn_list	A vector of all sensor nodes.
@@ -133,12 +148,13 @@ public:
 	*   @param cur_gen	Current generation id.
 	*   @param cur_pdv	Current PDV id.
 	*   @param bh_num		The index of the black hole.
-	*   @param sn_list	A vector of all sensor nodes.
-	*   @param req_ps		A vector of @a Point objects to be recharged.
 	*   @param tar_vec	The target vector at specific population id.
+	*   @param rng		The RNG stream of the star.
+	*   @param dirty		Flags of the sub paths changed by the swaps, set but never cleared here.
+	*   @return			The number of swaps made.
 	*   @tparam T		The type of data to present point coordinates.
 	*/
-	void attraction(int cur_gen, int cur_pdv, const int& bh_num, vector<SensorNode<T>> sn_list, vector<Point<T>> req_ps, vector<vector<int>>& tar_vec);	
+	int attraction(int cur_gen, int cur_pdv, const int& bh_num, vector<vector<int>>& tar_vec, Rng& rng, vector<bool>& dirty);	
 
 	/*! @brief			Implement all processes of the genetic algorithm.
 	*
@@ -154,7 +170,7 @@ public:
 	*   @tparam T		The type of data to present point coordinates.
 	*   @return			A vector of points (target flight position).
 	*/
-	void calcFinalPath(int case_num, vector<SensorNode<T>> sn_list, vector<SensorNode<T>*> candidates);
+	void calcFinalPath(int case_num, vector<SensorNode<T>>& sn_list, vector<SensorNode<T>*> candidates);
 
 	/*! @brief			Check if the number of requested sensor nodes is larger than @a min_req_num.
 	*   @param sn_list			A vector of all sensor nodes.
@@ -2,11 +2,14 @@
 #include <string>
 #include <iostream>
 #include <algorithm>
+#include <mutex>
+#include <thread>
 #include "cases.h"
 #include "pdv.h"
 #include "genetic.h"
 #include "blackhole.h"
 #include "annealing.h"
+#include "sensorfleet.h"
 
 using namespace std;
 
@@ -24,35 +27,35 @@ void Cases<T>::initAlgResults() {
 
 template <class T>
 void Cases<T>::readInputs(int n_file, std::vector<SensorNode<T>>& sn_list) {
-	fstream file;
-	file.open("../input/input" + to_string(n_file) + ".csv", fstream::in);
-	if (!file) {
+	FleetView<T> fleet;
+	if (!this->loadFleet(n_file, fleet)) return;
+	sn_list.insert(sn_list.end(), fleet.read().begin(), fleet.read().end());
+}
+
+template <class T>
+bool Cases<T>::loadFleet(int n_file, FleetView<T>& fleet) {
+	InputFleet input;
+	if (!input.load("../input/input" + to_string(n_file) + ".csv")) {
 		cerr << "input" + to_string(n_file) + ".csv cannot open";
-		return;
+		return false;
 	}
 
-	string line;
-	if (file.good()) getline(file, line);
-
-	string xs, ys, flags, volts, weights;
-	while (getline(file, xs, ',')) {
-		getline(file, ys, ',');
-		getline(file, flags, ',');
-		getline(file, volts, ',');
-		getline(file, weights);
-
-		sn_list.push_back(SensorNode<T>(static_cast<float>(stof(xs) / 100.),
-			static_cast<float>(stof(ys) / 100.), stof(volts), stoi(weights),
-			static_cast<bool>(stoi(flags))));
-	}
-	file.close();
+	fleet = FleetView<T>(input);
+	return true;
 }
 
 template <class T>
 void Cases<T>::executeGA(int case_num, vector<SensorNode<T>>& sn_list, int w_rec, int w_pdv, int w_dist,
-	int gen_num, int pop_num, int cr_num, int rec_num, int max_neigh) {
+	int gen_num, int pop_num, int cr_num, int rec_num, int max_neigh, EvalMode mode, int n_threads) {
 
 	Genetic<T>* ga = new Genetic<T>(w_rec, w_pdv, w_dist, gen_num, pop_num, cr_num, rec_num, max_neigh);
+	ga->eval_mode = mode;
+	ga->seed = this->seed;
+	ga->load_guess = this->load_guess;
+	ga->save_guess = this->save_guess;
+	ga->n_threads = n_threads;
+	ga->conv = this->conv.get();
+	ga->stop_rule = this->stop_rule;
 	if (!ga->checkTask(case_num, sn_list)) {
 		delete ga;
 		cerr << "No enough sensor nodes to be recharged !";
@@ -71,12 +74,17 @@ void Cases<T>::executeGA(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 		}
 	}
 
+	AcousGraph<T> acous(sn_list);
+
 	float* pect_list = new float[n_pdv];
 	double* pdv_eng_cost = new double[n_pdv];
 	double* delta_wsn_eng = new double[n_pdv];
 	double* flight_ds = new double[n_pdv];
 	double* flight_time = new double[n_pdv];
 
+	//! Racing algorithms share the recorder, so their flights are recorded one after another.
+	unique_lock<mutex> trace_guard(this->trace_lock, defer_lock);
+	if (this->trace.isEnabled()) trace_guard.lock();
 	for (int i = 0; i < n_pdv; i++) {
 		pect_list[i] = (float)(0.);
 		pdv_eng_cost[i] = 0.;
@@ -87,7 +95,8 @@ void Cases<T>::executeGA(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 		auto* pdv = new PDV<T>();
 		float pect = 0.;
 
-		pect = pdv->flightSimulation(delta_wsn_eng[i], flight_time[i], sn_list, final_sols[i]);
+		pect = pdv->flightSimulation(delta_wsn_eng[i], flight_time[i], sn_list, final_sols[i], acous,
+			mode == EvalMode::ORDERED, this->trace.get(), i);
 
 		pect_list[i] = pect;
 		pdv_eng_cost[i] = 187. - pdv->f_eng;
@@ -99,6 +108,8 @@ void Cases<T>::executeGA(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 
 		delete pdv;
 	}
+	this->trace.flush();
+	if (trace_guard.owns_lock()) trace_guard.unlock();
 
 	this->alg_pect[0] /= n_pdv;
 
@@ -107,13 +118,7 @@ void Cases<T>::executeGA(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 		if (flight_time[i] > max_t) max_t = flight_time[i];
 	}
 
-	for (unsigned i = 0; i < sn_list.size(); i++) {
-		if (sn_list[i].SC_V > sn_list[i].getCriticalVolt()) {
-			sn_list[i].updateEnergy(max_t * 3600, sn_list[i].SC_E);
-			sn_list[i].updateVolt(sn_list[i].SC_V);
-			sn_list[i].updateWeight(sn_list[i].SC_V, sn_list[i].weight);
-		}
-	}
+	SensorFleet<T>::drain(sn_list, max_t * 3600);
 
 	fstream file;
 	file.open("../output/ga_sum.csv", fstream::app);
@@ -125,11 +130,13 @@ void Cases<T>::executeGA(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 	for (int j = 0; j < n_pdv; j++) {
 		file << j << "," << flight_ds[j] << "," << pect_list[j]
 			<< "," << pdv_eng_cost[j] << "," << delta_wsn_eng[j]
-			<< "," << ga->alg_time << endl;
+			<< "," << ga->alg_time << "," << stopReasonName(ga->stop_reason) << "," << ga->steps_run << "," << ga->progress << endl;
 	}
 	file << endl;
 	file.close();
 
+	if (SolverStats::enabled()) ga->stats.appendCsv("../output/ga_stats.csv", case_num, ga->alg_time);
+
 	delete ga;
 	delete[] pect_list;
 	delete[] pdv_eng_cost;
@@ -140,9 +147,16 @@ void Cases<T>::executeGA(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 
 template <class T>
 void Cases<T>::executeBH(int case_num, vector<SensorNode<T>>& sn_list, int w_rec, int w_pdv, int w_dist,
-	int gen_num, int pop_num, int ar_num, int rec_num, int max_neigh) {
+	int gen_num, int pop_num, int ar_num, int rec_num, int max_neigh, EvalMode mode, int n_threads) {
 
 	BlackHole<T>* bh = new BlackHole<T>(w_rec, w_pdv, w_dist, gen_num, pop_num, ar_num, rec_num, max_neigh);
+	bh->eval_mode = mode;
+	bh->seed = this->seed;
+	bh->load_guess = this->load_guess;
+	bh->save_guess = this->save_guess;
+	bh->n_threads = n_threads;
+	bh->conv = this->conv.get();
+	bh->stop_rule = this->stop_rule;
 	if (!bh->checkTask(case_num, sn_list)) {
 		delete bh;
 		cerr << "No enough sensor nodes to be recharged !";
@@ -161,12 +175,17 @@ void Cases<T>::executeBH(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 		}
 	}
 
+	AcousGraph<T> acous(sn_list);
+
 	float* pect_list = new float[n_pdv];
 	double* pdv_eng_cost = new double[n_pdv];
 	double* delta_wsn_eng = new double[n_pdv];
 	double* flight_ds = new double[n_pdv];
 	double* flight_time = new double[n_pdv];
 
+	//! Racing algorithms share the recorder, so their flights are recorded one after another.
+	unique_lock<mutex> trace_guard(this->trace_lock, defer_lock);
+	if (this->trace.isEnabled()) trace_guard.lock();
 	for (int i = 0; i < n_pdv; i++) {
 		pect_list[i] = (float)(0.);
 		pdv_eng_cost[i] = 0.;
@@ -177,7 +196,8 @@ void Cases<T>::executeBH(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 		auto* pdv = new PDV<T>();
 		float pect = 0.;
 
-		pect = pdv->flightSimulation(delta_wsn_eng[i], flight_time[i], sn_list, final_sols[i]);
+		pect = pdv->flightSimulation(delta_wsn_eng[i], flight_time[i], sn_list, final_sols[i], acous,
+			mode == EvalMode::ORDERED, this->trace.get(), i);
 
 		pect_list[i] = pect;
 		pdv_eng_cost[i] = 187. - pdv->f_eng;
@@ -189,6 +209,8 @@ void Cases<T>::executeBH(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 
 		delete pdv;
 	}
+	this->trace.flush();
+	if (trace_guard.owns_lock()) trace_guard.unlock();
 
 	this->alg_pect[1] /= n_pdv;
 
@@ -197,13 +219,7 @@ void Cases<T>::executeBH(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 		if (flight_time[i] > max_t) max_t = flight_time[i];
 	}
 
-	for (unsigned i = 0; i < sn_list.size(); i++) {
-		if (sn_list[i].SC_V > sn_list[i].getCriticalVolt()) {
-			sn_list[i].updateEnergy(max_t * 3600, sn_list[i].SC_E);
-			sn_list[i].updateVolt(sn_list[i].SC_V);
-			sn_list[i].updateWeight(sn_list[i].SC_V, sn_list[i].weight);
-		}
-	}
+	SensorFleet<T>::drain(sn_list, max_t * 3600);
 
 	fstream file;
 	file.open("../output/bh_sum.csv", fstream::app);
@@ -215,11 +231,13 @@ void Cases<T>::executeBH(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 	for (int j = 0; j < n_pdv; j++) {
 		file << j << "," << flight_ds[j] << "," << pect_list[j]
 			<< "," << pdv_eng_cost[j] << "," << delta_wsn_eng[j]
-			<< "," << bh->alg_time << endl;
+			<< "," << bh->alg_time << "," << stopReasonName(bh->stop_reason) << "," << bh->steps_run << "," << bh->progress << endl;
 	}
 	file << endl;
 	file.close();
 
+	if (SolverStats::enabled()) bh->stats.appendCsv("../output/bh_stats.csv", case_num, bh->alg_time);
+
 	delete bh;
 	delete[] pect_list;
 	delete[] pdv_eng_cost;
@@ -231,10 +249,18 @@ void Cases<T>::executeBH(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 template <class T>
 void Cases<T>::executeSA(int case_num, vector<SensorNode<T>>& sn_list, int w_rec, int w_pdv, int w_dist,
 	double init_temp, double min_temp, double temp_factor, int pop_num,
-	int rec_num, int max_neigh) {
+	int rec_num, int max_neigh, EvalMode mode, int n_threads, bool tempering) {
 
 	Annealing<T>* sa = new Annealing<T>(w_rec, w_pdv, w_dist, init_temp, min_temp, 
 		temp_factor, pop_num, rec_num, max_neigh);
+	sa->eval_mode = mode;
+	sa->seed = this->seed;
+	sa->load_guess = this->load_guess;
+	sa->save_guess = this->save_guess;
+	sa->n_threads = n_threads;
+	sa->conv = this->conv.get();
+	sa->stop_rule = this->stop_rule;
+	sa->tempering = tempering;
 
 	if (!sa->checkTask(case_num, sn_list)) {
 		delete sa;
@@ -254,12 +280,17 @@ void Cases<T>::executeSA(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 		}
 	}
 
+	AcousGraph<T> acous(sn_list);
+
 	float* pect_list = new float[n_pdv];
 	double* pdv_eng_cost = new double[n_pdv];
 	double* delta_wsn_eng = new double[n_pdv];
 	double* flight_ds = new double[n_pdv];
 	double* flight_time = new double[n_pdv];
 
+	//! Racing algorithms share the recorder, so their flights are recorded one after another.
+	unique_lock<mutex> trace_guard(this->trace_lock, defer_lock);
+	if (this->trace.isEnabled()) trace_guard.lock();
 	for (int i = 0; i < n_pdv; i++) {
 		pect_list[i] = (float)(0.);
 		pdv_eng_cost[i] = 0.;
@@ -270,7 +301,8 @@ void Cases<T>::executeSA(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 		auto* pdv = new PDV<T>();
 		float pect = 0.;
 
-		pect = pdv->flightSimulation(delta_wsn_eng[i], flight_time[i], sn_list, final_sols[i]);
+		pect = pdv->flightSimulation(delta_wsn_eng[i], flight_time[i], sn_list, final_sols[i], acous,
+			mode == EvalMode::ORDERED, this->trace.get(), i);
 
 		pect_list[i] = pect;
 		pdv_eng_cost[i] = 187. - pdv->f_eng;
@@ -282,6 +314,8 @@ void Cases<T>::executeSA(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 
 		delete pdv;
 	}
+	this->trace.flush();
+	if (trace_guard.owns_lock()) trace_guard.unlock();
 
 	this->alg_pect[2] /= n_pdv;
 
@@ -290,13 +324,7 @@ void Cases<T>::executeSA(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 		if (flight_time[i] > max_t) max_t = flight_time[i];
 	}
 
-	for (unsigned i = 0; i < sn_list.size(); i++) {
-		if (sn_list[i].SC_V > sn_list[i].getCriticalVolt()) {
-			sn_list[i].updateEnergy(max_t * 3600, sn_list[i].SC_E);
-			sn_list[i].updateVolt(sn_list[i].SC_V);
-			sn_list[i].updateWeight(sn_list[i].SC_V, sn_list[i].weight);
-		}
-	}
+	SensorFleet<T>::drain(sn_list, max_t * 3600);
 
 	fstream file;
 	file.open("../output/sa_sum.csv", fstream::app);
@@ -308,11 +336,13 @@ void Cases<T>::executeSA(int case_num, vector<SensorNode<T>>& sn_list, int w_rec
 	for (int j = 0; j < n_pdv; j++) {
 		file << j << "," << flight_ds[j] << "," << pect_list[j]
 			<< "," << pdv_eng_cost[j] << "," << delta_wsn_eng[j]
-			<< "," << sa->alg_time << endl;
+			<< "," << sa->alg_time << "," << stopReasonName(sa->stop_reason) << "," << sa->steps_run << "," << sa->progress << endl;
 	}
 	file << endl;
 	file.close();
 
+	if (SolverStats::enabled()) sa->stats.appendCsv("../output/sa_stats.csv", case_num, sa->alg_time);
+
 	delete sa;
 	delete[] pect_list;
 	delete[] pdv_eng_cost;
@@ -359,21 +389,22 @@ void Cases<T>::evaluateAlgResults(int input_num, int iter_num, vector<float> pec
 
 template<class T>
 void Cases<T>::single_test(int n) {
+	FleetView<T> fleet;
+	if (!this->loadFleet(n, fleet)) return;
+
 	for (int j = 0; j < 20; j++) {
 		this->initAlgResults();
 		cerr << "input " << to_string(n) << "\t iter " << to_string(j) << endl;
 
-		readInputs(n, this->in_sns);
-		executeGA(n, this->in_sns, 80, 20, 0, 50, 50, 50, 25, 5);
-		this->in_sns.clear();
+		//! Every algorithm starts from its own copy of the parsed input
+		FleetView<T> ga_view = fleet;
+		executeGA(n, ga_view.write(), 80, 20, 0, 50, 50, 50, 25, 5);
 
-		readInputs(n, this->in_sns);
-		executeBH(this->in_sns, 80, 20, 0, 50, 50, 50, 25, 5);
-		this->in_sns.clear();
+		FleetView<T> bh_view = fleet;
+		executeBH(n, bh_view.write(), 80, 20, 0, 50, 50, 50, 25, 5);
 
-		readInputs(n, this->in_sns);
-		executeSA(this->in_sns, 80, 20, 0, 1e3, 1e-4, 0.985, 25, 25, 5);
-		this->in_sns.clear();
+		FleetView<T> sa_view = fleet;
+		executeSA(n, sa_view.write(), 80, 20, 0, 1e3, 1e-4, 0.985, 25, 25, 5);
 
 		//this->evaluateAlgResults(n, j, this->alg_pect, this->alg_cost, this->alg_rec);
 	}
@@ -383,24 +414,86 @@ template <class T>
 void Cases<T>::ensemble_test() {
 
 	for (int i = 1; i < 2; i++) {
-		
+		FleetView<T> fleet;
+		if (!this->loadFleet(i, fleet)) continue;
+
 		for (int j = 0; j < 1; j++) {
 			this->initAlgResults();
 			cerr << "input " << to_string(i) << "\t iter " << to_string(j) << endl;
+
+			if (this->race) {
+				this->raceAlgs(i, j, fleet);
+				continue;
+			}
 			
-			//readInputs(i, this->in_sns);
-			//executeGA(i, this->in_sns, 80, 20, 0, 50, 50, 50, 25, 5);
-			//this->in_sns.clear();
+			//FleetView<T> ga_view = fleet;
+			//executeGA(i, ga_view.write(), 80, 20, 0, 50, 50, 50, 25, 5);
 
-			readInputs(i, this->in_sns);
-			executeBH(i, this->in_sns, 80, 20, 0, 50, 50, 50, 25, 5);
-			this->in_sns.clear();
+			FleetView<T> bh_view = fleet;
+			executeBH(i, bh_view.write(), 80, 20, 0, 50, 50, 50, 25, 5);
 
-			//readInputs(i, this->in_sns);
-			//executeSA(i, this->in_sns, 80, 20, 0, 1e3, 5e-3, 0.94, 25, 25, 5);
-			//this->in_sns.clear();
+			//FleetView<T> sa_view = fleet;
+			//executeSA(i, sa_view.write(), 80, 20, 0, 1e3, 5e-3, 0.94, 25, 25, 5);
 
 			//this->evaluateAlgResults(i, j, this->alg_pect, this->alg_cost, this->alg_rec);
 		}
 	}
-}
\ No newline at end of file
+}
+
+template <class T>
+void Cases<T>::raceAlgs(int case_num, int iter_num, const FleetView<T>& fleet) {
+	//! Every algorithm flies on its own copy of the parsed input, taken before the threads start.
+	FleetView<T> ga_view = fleet;
+	FleetView<T> bh_view = fleet;
+	FleetView<T> sa_view = fleet;
+	vector<SensorNode<T>>& ga_sns = ga_view.write();
+	vector<SensorNode<T>>& bh_sns = bh_view.write();
+	vector<SensorNode<T>>& sa_sns = sa_view.write();
+
+	//! One call per algorithm, shared by the sequential and the concurrent runs.
+	auto run_ga = [&](int n_threads) {
+		executeGA(case_num, ga_sns, 80, 20, 0, 50, 50, 50, 25, 5, EvalMode::GREEDY, n_threads);
+	};
+	auto run_bh = [&](int n_threads) {
+		executeBH(case_num, bh_sns, 80, 20, 0, 50, 50, 50, 25, 5, EvalMode::GREEDY, n_threads);
+	};
+	auto run_sa = [&](int n_threads) {
+		executeSA(case_num, sa_sns, 80, 20, 0, 1e3, 5e-3, 0.94, 25, 25, 5, EvalMode::GREEDY, n_threads);
+	};
+
+	//! The initial guess store of a case is shared by the algorithms, so it cannot be used concurrently.
+	if (this->load_guess || this->save_guess) {
+		cerr << "initial guess store in use, running the algorithms one after another" << endl;
+		run_ga(0);
+		run_bh(0);
+		run_sa(0);
+		this->evaluateAlgResults(case_num, iter_num, this->alg_pect, this->alg_cost, this->alg_rec);
+		return;
+	}
+
+	//! Split the hardware threads into one group per algorithm, SA takes the remainder.
+	int n_hw = max(static_cast<int>(thread::hardware_concurrency()), 1);
+	int n_group = max(n_hw / 3, 1);
+	int n_sa = max(n_hw - 2 * n_group, 1);
+
+	{
+		//! Joins the racers on every exit, so an exception on this thread does not terminate the program.
+		struct JoinGuard {
+			vector<thread>& racers;
+			~JoinGuard() {
+				for (thread& t : racers) {
+					if (t.joinable()) t.join();
+				}
+			}
+		};
+
+		vector<thread> racers;
+		racers.reserve(2);
+		JoinGuard guard{ racers };
+		racers.emplace_back(run_ga, n_group);
+		racers.emplace_back(run_bh, n_group);
+		run_sa(n_sa);
+	}
+
+	this->evaluateAlgResults(case_num, iter_num, this->alg_pect, this->alg_cost, this->alg_rec);
+}
@@ -1,5 +1,11 @@
 #pragma once
+#include <mutex>
 #include "sensornode.h"
+#include "fitness.h"
+#include "fleetio.h"
+#include "flighttrace.h"
+#include "convergence.h"
+#include "stoprule.h"
 
 #ifndef CASES_H_
 #define CASES_H_
@@ -11,24 +17,36 @@ public:
 	std::vector<float> alg_pect;
 	std::vector<double> alg_cost;
 	std::vector<double> alg_rec;
+	uint64_t seed = 0;		/*!< Seed passed to every algorithm, 0 for a time-based seed */
+	bool load_guess = false;	/*!< Read initial populations from the case stores instead of building them */
+	bool save_guess = false;	/*!< Write the built initial populations to the case stores */
+	FlightTrace trace;		/*!< Recorder of the simulated flights, disabled by default */
+	ConvergenceStream conv;	/*!< Stream of the per-generation solver progress, disabled by default */
+	StopRule stop_rule;		/*!< Early termination rules passed to every algorithm, disabled by default */
+	bool race = false;		/*!< Run GA, BH and SA of @a ensemble_test concurrently instead of one after another */
 
 	Cases() {};
 	~Cases() {};
 
 	void initAlgResults();
 	void readInputs(int n_file, std::vector<SensorNode<T>>& sn_list);
+	bool loadFleet(int n_file, FleetView<T>& fleet);
 	void executeGA(int case_num, std::vector<SensorNode<T>>& sn_list, int w_rec, int w_pdv, int w_dist,
-		int gen_num, int pop_num, int cr_num, int rec_num, int max_neigh);
+		int gen_num, int pop_num, int cr_num, int rec_num, int max_neigh, EvalMode mode = EvalMode::GREEDY, int n_threads = 0);
 	void executeBH(int case_num, std::vector<SensorNode<T>>& sn_list, int w_rec, int w_pdv, int w_dist,
-		int gen_num, int pop_num, int ar_num, int rec_num, int max_neigh);
+		int gen_num, int pop_num, int ar_num, int rec_num, int max_neigh, EvalMode mode = EvalMode::GREEDY, int n_threads = 0);
 	void executeSA(int case_num, std::vector<SensorNode<T>>& sn_list, int w_rec, int w_pdv, int w_dist,
 		double init_temp, double min_temp, double temp_factor, int pop_num,
-		int rec_num, int max_neigh);
+		int rec_num, int max_neigh, EvalMode mode = EvalMode::GREEDY, int n_threads = 0, bool tempering = false);
 	
 	void single_test(int n);
 	void ensemble_test();
+	void raceAlgs(int case_num, int iter_num, const FleetView<T>& fleet);
 
 	void evaluateAlgResults(int input_num, int iter_num, std::vector<float> pect_, std::vector<double> cost_, std::vector<double> rec_);
+
+private:
+	std::mutex trace_lock;		/*!< Held by an algorithm while its flights are recorded */
 };
 
 #endif // !CASES_H_
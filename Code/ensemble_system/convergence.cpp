@@ -0,0 +1,103 @@
+/*! @file convergence.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include "convergence.h"
+
+using namespace std;
+
+bool ConvergenceStream::enable(const string& fname, Format format) {
+	this->disable();
+
+	fstream::openmode mode = fstream::out | fstream::trunc;
+	if (format == Format::BINARY) mode |= fstream::binary;
+	try {
+		this->file.open(fname, mode);
+		if (!this->file.is_open()) throw runtime_error(fname + ": " + strerror(errno));
+	}
+	catch (const exception& e) {
+		cerr << e.what() << "\n";
+		return false;
+	}
+
+	this->format = format;
+	if (format == Format::BINARY) {
+		uint32_t head[2] = { CONV_STREAM_MAGIC, CONV_STREAM_VERSION };
+		this->file.write(reinterpret_cast<const char*>(head), sizeof(head));
+	}
+	else {
+		this->file << "alg,case,chain,step,temp,best,mean,worst,accept_rate,replaced\n";
+	}
+
+	this->stop.store(false);
+	this->dropped.store(0);
+	this->writer = thread(&ConvergenceStream::drain, this);
+	return true;
+}
+
+void ConvergenceStream::disable() {
+	if (!this->writer.joinable()) return;
+
+	this->stop.store(true, memory_order_release);
+	this->writer.join();
+	this->file.close();
+
+	if (this->getDropped()) cerr << "convergence stream dropped " << this->getDropped() << " samples\n";
+}
+
+ConvergenceStream::Sample ConvergenceStream::summarise(Alg alg, int case_num, int step, const vector<vector<double>>& metrics,
+	int col) {
+	Sample s = Sample();
+	s.alg = static_cast<int32_t>(alg);
+	s.case_num = case_num;
+	s.chain = -1;
+	s.step = step;
+	if (metrics.empty()) return s;
+
+	s.best = s.worst = metrics[0][col];
+	for (const vector<double>& m : metrics) {
+		s.best = max(s.best, m[col]);
+		s.worst = min(s.worst, m[col]);
+		s.mean += m[col];
+	}
+	s.mean /= metrics.size();
+	return s;
+}
+
+void ConvergenceStream::drain() {
+	Sample s;
+	for (;;) {
+		//! Read the flag first, so samples pushed before it was set are still drained below.
+		bool last = this->stop.load(memory_order_acquire);
+		bool any = false;
+		while (this->ring.tryPop(s)) {
+			this->write(s);
+			any = true;
+		}
+		if (last) break;
+		if (!any) this_thread::sleep_for(chrono::milliseconds(1));
+	}
+	this->file.flush();
+}
+
+void ConvergenceStream::write(const Sample& s) {
+	if (this->format == Format::BINARY) {
+		this->file.write(reinterpret_cast<const char*>(&s), sizeof(Sample));
+		return;
+	}
+
+	static const char* alg_names[] = { "ga", "bh", "sa" };
+	this->file << alg_names[s.alg] << "," << s.case_num << "," << s.chain << "," << s.step << ","
+		<< s.temp << "," << s.best << "," << s.mean << "," << s.worst << ","
+		<< s.accept_rate << "," << s.replaced << "\n";
+}
@@ -0,0 +1,134 @@
+/*! @file	convergence.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mpmcring.h"
+
+#ifndef CONVERGENCE_H_
+#define CONVERGENCE_H_
+
+//! Magic number of the binary convergence file ("ODPC")
+#define CONV_STREAM_MAGIC 0x4350444Fu
+//! Version of the binary convergence file layout
+#define CONV_STREAM_VERSION 1u
+//! Samples the ring holds before producers start dropping them
+#define CONV_RING_SIZE 16384
+//! SA steps summarised by one chain sample
+#define CONV_SA_WINDOW 10
+
+/*! @class		ConvergenceStream convergence.h "convergence.h"
+*   @brief		Implementation of @a ConvergenceStream class
+*
+*   The @a ConvergenceStream class streams per-generation (or per temperature
+*   window) progress of the solvers to a file. Solvers push @a Sample records
+*   into a lock-free @a MpmcRing and a background thread drains it to a csv
+*   file or a binary file made of a header (magic, version) and packed
+*   @a Sample records. A push never blocks: if the writer falls behind and the
+*   ring is full, the sample is dropped and counted. A disabled stream is a
+*   null pointer for the solvers, so it costs nothing in their loops.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+class ConvergenceStream
+{
+	//! @publicsection
+public:
+	//! Sink formats.
+	enum class Format { CSV, BINARY };
+
+	//! Solver writing a sample.
+	enum class Alg : int32_t { GA, BH, SA };
+
+	//! Progress of one generation, or of one SA window.
+	struct Sample {
+		double best;		/*!< Best fitness of the population (or of the chain target) */
+		double mean;		/*!< Mean fitness */
+		double worst;		/*!< Worst fitness */
+		double accept_rate;	/*!< GA: trails kept, SA: steps accepted, over the sample [0, 1] */
+		double temp;		/*!< SA temperature at the end of the sample, 0 otherwise */
+		int32_t alg;		/*!< An @a Alg value */
+		int32_t case_num;	/*!< Case id of the run */
+		int32_t chain;		/*!< SA chain id, -1 for the whole population */
+		int32_t step;		/*!< Generation, or SA step at the end of the sample */
+		int32_t replaced;	/*!< BH stars swallowed and re-initialised */
+		int32_t reserved;	/*!< Padding, always 0 */
+	};
+
+	//! A default constructer, the stream is disabled.
+	ConvergenceStream() {}
+
+	//! A destructer which drains the ring and stops the writer.
+	~ConvergenceStream() { this->disable(); }
+
+	ConvergenceStream(const ConvergenceStream&) = delete;
+	ConvergenceStream& operator=(const ConvergenceStream&) = delete;
+
+	/*! @brief			Truncate a sink and start the writer thread.
+	*   @param fname		Path of the sink file.
+	*   @param format		Format of the sink.
+	*   @return			If the sink can be opened, return true.
+	*/
+	bool enable(const std::string& fname, Format format = Format::CSV);
+
+	//! Write the remaining samples, stop the writer and close the sink.
+	void disable();
+
+	//! Check if samples are written.
+	bool isEnabled() const { return this->writer.joinable(); }
+
+	/*! @brief			The stream to hand to the solvers.
+	*   @return			This object if it is enabled, otherwise a null pointer.
+	*/
+	ConvergenceStream* get() { return this->isEnabled() ? this : nullptr; }
+
+	//! Queue one sample, or drop it if the ring is full.
+	void push(const Sample& s) {
+		if (!this->ring.tryPush(s)) this->dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/*! @brief			Summarise a population.
+	*   @param alg		The solver.
+	*   @param case_num	Case id of the run.
+	*   @param step		Generation id.
+	*   @param metrics	Fitness metrics of every member.
+	*   @param col		Column of @a metrics holding the total fitness.
+	*   @return			A population sample (chain -1) with best, mean and worst set and the rest 0.
+	*/
+	static Sample summarise(Alg alg, int case_num, int step, const std::vector<std::vector<double>>& metrics, int col);
+
+	//! Access the number of samples dropped so far.
+	uint64_t getDropped() const { return this->dropped.load(std::memory_order_relaxed); }
+
+	//! @privatesection
+private:
+	MpmcRing<Sample> ring{ CONV_RING_SIZE };
+	std::thread writer;
+	std::atomic<bool> stop{ false };
+	std::atomic<uint64_t> dropped{ 0 };
+	Format format = Format::CSV;
+	std::fstream file;			/*!< The sink, only used by @a writer while it runs */
+
+	//! Body of the writer thread.
+	void drain();
+
+	//! Write one sample to the sink.
+	void write(const Sample& s);
+};
+
+#endif // !CONVERGENCE_H_
@@ -0,0 +1,116 @@
+/*! @file distoracle.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include "distoracle.h"
+
+using namespace std;
+
+template <class T>
+DistOracle<T>::DistOracle() {
+	this->build(vector<Point<T>>());
+}
+
+template <class T>
+DistOracle<T>::DistOracle(const vector<Point<T>>& req_ps, size_t mem_budget) {
+	this->build(req_ps, mem_budget);
+}
+
+template <class T>
+DistOracle<T>::~DistOracle() {}
+
+template <class T>
+void DistOracle<T>::build(const vector<Point<T>>& req_ps, size_t mem_budget) {
+	this->n_req = req_ps.size();
+	this->xs.resize(this->n_req + 1);
+	this->ys.resize(this->n_req + 1);
+	for (int i = 0; i < this->n_req; i++) {
+		this->xs[i] = req_ps[i].getX();
+		this->ys[i] = req_ps[i].getY();
+	}
+	//! The base station is always at the origin.
+	this->xs[this->n_req] = static_cast<T>(0);
+	this->ys[this->n_req] = static_cast<T>(0);
+
+	this->index.build(this->xs.data(), this->ys.data(), this->n_req);
+
+	size_t n_all = this->n_req + 1;
+	size_t tri_bytes = n_all * (n_all - 1) / 2 * sizeof(float);
+	this->tri.clear();
+	this->cands.clear();
+
+	if (tri_bytes <= mem_budget) {
+		this->dense = true;
+		this->tri.resize(n_all * (n_all - 1) / 2);
+		for (size_t i = 1; i < n_all; i++) {
+			size_t row = i * (i - 1) / 2;
+			for (size_t j = 0; j < i; j++) {
+				this->tri[row + j] = static_cast<float>(hypot(this->xs[i] - this->xs[j], this->ys[i] - this->ys[j]));
+			}
+		}
+	}
+	else {
+		this->dense = false;
+		this->buildCands();
+	}
+}
+
+template <class T>
+void DistOracle<T>::buildCands() {
+	int n = this->n_req;
+	this->cands.assign(static_cast<size_t>(n) * DIST_CAND_NUM, -1);
+
+	vector<int> found;
+	for (int a = 0; a < n; a++) {
+		this->index.query(this->xs[a], this->ys[a], DIST_CAND_NUM + 1, found);
+		int keep = 0;
+		for (unsigned k = 0; k < found.size() && keep < DIST_CAND_NUM; k++) {
+			if (found[k] != a) this->cands[static_cast<size_t>(a) * DIST_CAND_NUM + keep++] = found[k];
+		}
+	}
+}
+
+template <class T>
+size_t DistOracle<T>::getMemBytes() const {
+	return this->tri.size() * sizeof(float) + this->cands.size() * sizeof(int)
+		+ (this->xs.size() + this->ys.size()) * sizeof(T);
+}
+
+template <class T>
+int DistOracle<T>::nearestTo(const double& x, const double& y) const {
+	int best = this->index.nearest(static_cast<T>(x), static_cast<T>(y));
+	return best < 0 ? 0 : best;
+}
+
+template <class T>
+int DistOracle<T>::nthNearest(const int& a, const int& num) const {
+	if (num <= 0) return a;
+
+	if (!this->dense && num <= DIST_CAND_NUM) {
+		int c = this->cands[static_cast<size_t>(a) * DIST_CAND_NUM + num - 1];
+		if (c >= 0) return c;
+	}
+
+	//! Node @a a is excluded so it keeps rank 0 even next to coincident nodes.
+	vector<int> found;
+	this->index.query(this->xs[a], this->ys[a], num + 1, found);
+	found.erase(remove(found.begin(), found.end(), a), found.end());
+	if (found.empty()) return a;
+	return found[min(num, static_cast<int>(found.size())) - 1];
+}
+
+template <class T>
+void DistOracle<T>::printOracleInfo() const {
+	cout << "Distance Oracle Information:" << endl << endl
+		<< "Requested nodes: \t" << this->n_req << endl
+		<< "Mode: \t" << (this->dense ? "dense matrix" : "on-demand with candidate lists") << endl
+		<< "Memory: \t" << this->getMemBytes() / 1024. << " KB" << endl
+		<< endl;
+}
@@ -0,0 +1,152 @@
+/*! @file	distoracle.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <cmath>
+#include <vector>
+#include "point.h"
+#include "nearest.h"
+#include "knnindex.h"
+
+#ifndef DISTORACLE_H_
+#define DISTORACLE_H_
+
+//! Default memory budget of the dense distance matrix [bytes]
+#define DIST_MEM_BUDGET (256u << 20)
+//! Number of nearest neighbours kept per node when the matrix is not stored
+#define DIST_CAND_NUM 16
+
+/*! @class		DistOracle distoracle.h "distoracle.h"
+*   @brief		Implementation of @a DistOracle class
+*
+*   The @a DistOracle class answers distance queries between the requested
+*   sensor nodes and the base station. Node ids are the positions in the
+*   requested list, and the base station takes id @a getBase() (the last one).
+*   If the lower triangle of the full matrix fits in the memory budget it is
+*   stored as @c float , otherwise distances are computed on demand and the
+*   nearest @a DIST_CAND_NUM neighbours of every node are kept as candidate
+*   lists. Both modes return the same @c float rounded values. Neighbour
+*   queries go through a @a KnnIndex over the requested nodes.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+template <class T>
+class DistOracle
+{
+	//! @publicsection
+public:
+	//! A default constructer with only the base station.
+	DistOracle();
+
+	/*! @brief			Build the oracle over the requested nodes.
+	*   @param req_ps		A vector of @a Point objects of all sensor nodes to be recharged.
+	*   @param mem_budget	Maximum size of the dense matrix [bytes].
+	*/
+	DistOracle(const std::vector<Point<T>>& req_ps, size_t mem_budget = DIST_MEM_BUDGET);
+
+	//! A default destructer.
+	~DistOracle();
+
+	/*! @brief			(Re-)build the oracle over the requested nodes.
+	*   @param req_ps		A vector of @a Point objects of all sensor nodes to be recharged.
+	*   @param mem_budget	Maximum size of the dense matrix [bytes].
+	*/
+	void build(const std::vector<Point<T>>& req_ps, size_t mem_budget = DIST_MEM_BUDGET);
+
+	/*! @brief			Distance between two nodes.
+	*   @param a		Id of the first node.
+	*   @param b		Id of the second node.
+	*   @return			The distance [m].
+	*/
+	float dist(const int& a, const int& b) const {
+		if (a == b) return 0.f;
+		if (this->dense) {
+			int hi = a > b ? a : b;
+			int lo = a + b - hi;
+			return this->tri[static_cast<size_t>(hi) * (hi - 1) / 2 + lo];
+		}
+		return static_cast<float>(std::hypot(this->xs[a] - this->xs[b], this->ys[a] - this->ys[b]));
+	}
+
+	/*! @brief			Id of the base station.
+	*   @return			The number of requested nodes.
+	*/
+	int getBase() const { return this->n_req; }
+
+	/*! @brief			Access the position of node @a a .
+	*   @param a		Id of the node.
+	*   @return			A @a Point object of the node.
+	*/
+	Point<T> getPoint(const int& a) const { return Point<T>(this->xs[a], this->ys[a]); }
+
+	/*! @brief			Check if the full matrix is stored.
+	*   @return			true for the dense mode, false for the on-demand mode.
+	*/
+	bool isDense() const { return this->dense; }
+
+	/*! @brief			Access the k-NN index over the requested nodes.
+	*   @return			An index with every requested node live, ids as in the oracle.
+	*/
+	const KnnIndex<T>& getIndex() const { return this->index; }
+
+	/*! @brief			Memory used by the stored distances or candidate lists.
+	*   @return			Size in bytes.
+	*/
+	size_t getMemBytes() const;
+
+	/*! @brief			Find the requested node nearest to a point.
+	*   @param x		x coordinate of the point.
+	*   @param y		y coordinate of the point.
+	*   @return			Id of the nearest requested node, the lowest id on ties.
+	*/
+	int nearestTo(const double& x, const double& y) const;
+
+	/*! @brief			Find the node of @a ids nearest to node @a a .
+	*   @param a		Id of the node.
+	*   @param ids		Ids of the candidate nodes, not empty.
+	*   @return			Position in @a ids of the nearest node, the lowest position on ties.
+	*/
+	int nearestAmong(const int& a, const std::vector<int>& ids) const {
+		return nearestIndex(this->xs.data(), this->ys.data(), ids.data(), ids.size(), this->xs[a], this->ys[a]);
+	}
+
+	/*! @brief			Find the @a num th nearest requested node of node @a a .
+	*
+	*   Node @a a itself is the 0th nearest. In the on-demand mode the candidate
+	*   lists are used when @a num is small enough, otherwise the k-NN index is
+	*   queried.
+	*
+	*   @param a		Id of the node.
+	*   @param num		Rank of the neighbour.
+	*   @return			Id of the neighbour, ties are broken by the lower id.
+	*/
+	int nthNearest(const int& a, const int& num) const;
+
+	//! Print the storage mode and used memory
+	void printOracleInfo() const;
+
+	//! @privatesection
+private:
+	int n_req = 0;					/*!< Number of requested nodes */
+	bool dense = true;				/*!< If the lower triangle is stored */
+	std::vector<T> xs;				/*!< x coordinates, base station last */
+	std::vector<T> ys;				/*!< y coordinates, base station last */
+	std::vector<float> tri;				/*!< Lower triangle of the distance matrix */
+	std::vector<int> cands;				/*!< Candidate lists, @a DIST_CAND_NUM per node */
+	KnnIndex<T> index;				/*!< Grid index over the requested nodes */
+
+	//! Build the candidate lists from the k-NN index.
+	void buildCands();
+};
+
+#endif // !DISTORACLE_H_
@@ -0,0 +1,153 @@
+/*! @file fitness.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <cmath>
+#include <vector>
+#include "fitness.h"
+#include "funcs.h"
+#include "pdv.h"
+
+using namespace std;
+
+template <class T>
+FitnessEval<T>::FitnessEval(const vector<SensorNode<T>>& sn_list, const vector<int>& req_idx, int w_wsn_eng, int w_pdv_eng,
+		EvalMode eval_mode, size_t dist_budget) : fleet(sn_list), acous(sn_list), coeff_wsn_eng(w_wsn_eng), coeff_pdv_eng(w_pdv_eng),
+		mode(eval_mode) {
+	//! Resolve coincident nodes once, the first match wins as in the old linear search.
+	this->cn_idx.resize(this->fleet.size());
+	PointGrid<T> grid(COINCIDE_TOL, this->fleet.size());
+	for (unsigned i = 0; i < this->fleet.size(); i++) {
+		Point<T> pos = this->fleet.getPos(i);
+		int first = grid.findCoincide(pos);
+		this->cn_idx[i] = first < 0 ? i : first;
+		grid.insert(pos);
+	}
+
+	//! Node states are fixed within a round, so visiting costs are computed only once.
+	PDV<T> pdv;
+	this->slot_of.assign(this->fleet.size(), -1);
+	this->cost.resize(req_idx.size());
+	for (unsigned i = 0; i < req_idx.size(); i++) {
+		int this_cn = this->cn_idx[req_idx[i]];
+		this->slot_of[req_idx[i]] = i;
+
+		pdv.iptEnergyCost(this->fleet.node(this_cn), this->cost[i].ipt_eng);
+		this->cost[i].pckt = this->fleet.calcPackage(this_cn) - 12.;
+		this->cost[i].max_eng = this->fleet.calcMaxEnergy(this_cn);
+		this->cost[i].acous_eng = 0.;
+		for (int k = this->acous.rowBegin(this_cn); k < this->acous.rowEnd(this_cn); k++) {
+			double temp_g = exp(-1. * pow(2 * PI * 47500, EFF_ACOUS) * this->acous.getDist(k) * ALPHA_MAT);
+			this->cost[i].acous_eng += EFF_PIEZO * EFF_PIEZO * EFF_ACOUS2DC * temp_g * ACOUS_ENERGY_SEND;
+		}
+	}
+
+	vector<Point<T>> req_ps(req_idx.size());
+	for (unsigned i = 0; i < req_idx.size(); i++) req_ps[i] = this->fleet.getPos(req_idx[i]);
+	this->oracle.build(req_ps, dist_budget);
+}
+
+template <class T>
+FitnessEval<T>::~FitnessEval() {}
+
+template <class T>
+double FitnessEval<T>::calcFitness(const vector<int>& idx_list) const {
+	EvalScratch scratch;
+	return this->calcFitness(idx_list, scratch);
+}
+
+template <class T>
+double FitnessEval<T>::calcFitness(const vector<int>& idx_list, EvalScratch& scratch) const {
+	SOLVER_COUNT(scratch.stats, FITNESS_CALLS, 1);
+	if (this->mode == EvalMode::ORDERED) {
+		SOLVER_COUNT(scratch.stats, DIST_EVALS, 2 * idx_list.size() + 1);
+		return this->calcOrderedFitness(idx_list);
+	}
+
+	vector<int>& remain = scratch.remain;
+	remain.resize(idx_list.size());
+	for (unsigned i = 0; i < idx_list.size(); i++) remain[i] = this->slot_of[idx_list[i]];
+
+	PDV<T> pdv;
+	const Point<T> home;
+	const int base = this->oracle.getBase();
+	int cur = base;
+	double charged_eng = 0., total_eng = 0.;
+
+	while (remain.size()) {
+		//! Nearest node first, ties go to the earlier one in the sub path.
+		int next = this->oracle.nearestAmong(cur, remain);
+		SOLVER_COUNT(scratch.stats, DIST_EVALS, remain.size() + 2);
+		float min_d = this->oracle.dist(cur, remain[next]);
+
+		int slot = remain[next];
+		const NodeCost& nc = this->cost[slot];
+
+		if (pdv.calcEnergyCost(this->oracle.dist(slot, base) / pdv.getPdvSpeed()) +
+			pdv.calcEnergyCost(min_d / pdv.getPdvSpeed()) > pdv.f_eng) {
+			return -1000.;
+		}
+
+		pdv.updatePdvStatus(this->oracle.getPoint(slot), min_d);
+		cur = slot;
+
+		//! IPT to the center node and acoustic power transfer to its neighbours
+		pdv.f_eng -= nc.ipt_eng;
+		charged_eng += nc.pckt + nc.acous_eng;
+		total_eng += nc.max_eng;
+
+		remain.erase(remain.begin() + next);
+	}
+
+	//! Return to home process
+	pdv.updatePdvStatus(home, this->oracle.dist(cur, base));
+	SOLVER_COUNT(scratch.stats, DIST_EVALS, 1);
+
+	return this->calcMetric(charged_eng, total_eng, pdv.f_eng);
+}
+
+template <class T>
+double FitnessEval<T>::calcOrderedFitness(const vector<int>& idx_list) const {
+	PDV<T> pdv;
+	const Point<T> home;
+	const int base = this->oracle.getBase();
+	int cur = base;
+	double charged_eng = 0., total_eng = 0.;
+
+	for (unsigned i = 0; i < idx_list.size(); i++) {
+		int slot = this->slot_of[idx_list[i]];
+		const NodeCost& nc = this->cost[slot];
+		float d = this->oracle.dist(cur, slot);
+
+		if (pdv.calcEnergyCost(this->oracle.dist(slot, base) / pdv.getPdvSpeed()) +
+			pdv.calcEnergyCost(d / pdv.getPdvSpeed()) > pdv.f_eng) {
+			return -1000.;
+		}
+
+		pdv.updatePdvStatus(this->oracle.getPoint(slot), d);
+		cur = slot;
+
+		//! IPT to the center node and acoustic power transfer to its neighbours
+		pdv.f_eng -= nc.ipt_eng;
+		charged_eng += nc.pckt + nc.acous_eng;
+		total_eng += nc.max_eng;
+	}
+
+	//! Return to home process
+	pdv.updatePdvStatus(home, this->oracle.dist(cur, base));
+
+	return this->calcMetric(charged_eng, total_eng, pdv.f_eng);
+}
+
+template <class T>
+double FitnessEval<T>::calcMetric(const double& charged_eng, const double& total_eng, const double& f_eng) const {
+	static const Funcs<double> funcs;
+	double wsn_e_fac = this->coeff_wsn_eng * funcs.tanhFunc(charged_eng / (total_eng * 0.9));		//! Wh
+	double pdv_e_fac = this->coeff_pdv_eng * funcs.invTanhFunc((187. - f_eng) / 187.);			//! Wh
+
+	return wsn_e_fac + pdv_e_fac;
+}
@@ -0,0 +1,182 @@
+/*! @file	fitness.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include "sensornode.h"
+#include "sensorfleet.h"
+#include "acousgraph.h"
+#include "distoracle.h"
+#include "solverstats.h"
+
+#ifndef FITNESS_H_
+#define FITNESS_H_
+
+/*! @struct		NodeCost fitness.h "fitness.h"
+*   @brief		Per-round cost of visiting one requested sensor node
+*
+*   All values depend only on the node states at the start of a planning round,
+*   so they are computed once and only read while scoring sub paths.
+*/
+struct NodeCost
+{
+	double ipt_eng = 0.;		/*!< PDV energy spent on inductive power transfer [Wh] */
+	double pckt = 0.;			/*!< Energy charged to the center node, minus 12 J for APT [J] */
+	double max_eng = 0.;		/*!< Maximum energy of the center node [J] */
+	double acous_eng = 0.;		/*!< Acoustic energy received by all its neighbours [J] */
+};
+
+/*! @struct		EvalScratch fitness.h "fitness.h"
+*   @brief		Working buffers of one evaluating thread
+*
+*   The buffers keep their capacity between calls, so a thread scoring many sub
+*   paths in a row does not allocate after the first one.
+*/
+struct EvalScratch
+{
+	std::vector<int> remain;		/*!< Slots not visited yet */
+	SolverStats stats;			/*!< Phase times and event counts of the thread using it */
+};
+
+/*! @enum		EvalMode fitness.h "fitness.h"
+*   @brief		How a sub path is turned into a visiting order
+*/
+enum class EvalMode
+{
+	GREEDY,			/*!< Re-order the nodes nearest first, O(n^2) */
+	ORDERED			/*!< Visit the nodes in the given order, O(n) */
+};
+
+/*! @class		FitnessEval fitness.h "fitness.h"
+*   @brief		Implementation of @a FitnessEval class
+*
+*   The @a FitnessEval class is the fitness engine shared by @a Genetic,
+*   @a BlackHole and @a Annealing. It keeps one read-only snapshot of the
+*   sensor nodes for a whole planning round, so a sub path can be scored
+*   directly from its sensor indices without copying the node list or
+*   searching coincident nodes again. Acoustic neighbours are read from an
+*   @a AcousGraph built together with the snapshot, and the IPT, package and
+*   acoustic yields of each requested node are kept in a @a NodeCost table.
+*   Flight distances come from a @a DistOracle over the requested nodes.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+template <class T>
+class FitnessEval
+{
+	//! @publicsection
+public:
+	/*! @brief			Build the snapshot for one planning round.
+	*   @param sn_list	A vector of all sensor nodes.
+	*   @param req_idx	Indices of the sensor nodes to be recharged.
+	*   @param w_wsn_eng	Fitness metric factor for total recharged energy.
+	*   @param w_pdv_eng	Fitness metric factor for energy cost of the PDV.
+	*   @param eval_mode	How sub paths are ordered before scoring.
+	*   @param dist_budget	Memory budget of the distance oracle [bytes].
+	*/
+	FitnessEval(const std::vector<SensorNode<T>>& sn_list, const std::vector<int>& req_idx, int w_wsn_eng, int w_pdv_eng,
+		EvalMode eval_mode = EvalMode::GREEDY, size_t dist_budget = DIST_MEM_BUDGET);
+
+	//! A default destructer.
+	~FitnessEval();
+
+	/*! @brief			Access the read-only sensor node snapshot.
+	*   @return			The snapshot of all sensor nodes.
+	*/
+	const SensorFleet<T>& getFleet() const { return this->fleet; }
+
+	/*! @brief			Access the cost table entry of a requested sensor node.
+	*   @param sn_idx		Index of a requested sensor node.
+	*   @return			The per-round cost of visiting the node.
+	*/
+	const NodeCost& getCost(const int& sn_idx) const { return this->cost[this->slot_of[sn_idx]]; }
+
+	/*! @brief			Access the cost table entry of a distance oracle node.
+	*   @param slot		Node id in the distance oracle, not the base station.
+	*   @return			The per-round cost of visiting the node.
+	*/
+	const NodeCost& getSlotCost(const int& slot) const { return this->cost[slot]; }
+
+	/*! @brief			Access the node id of a requested sensor node in the distance oracle.
+	*   @param sn_idx		Index of a requested sensor node.
+	*   @return			The node id, which is its position in the requested list.
+	*/
+	int getSlot(const int& sn_idx) const { return this->slot_of[sn_idx]; }
+
+	/*! @brief			Access the distance oracle over the requested nodes and the base station.
+	*   @return			The distance oracle of this round.
+	*/
+	const DistOracle<T>& getOracle() const { return this->oracle; }
+
+	/*! @brief			Access the evaluation mode.
+	*   @return			The mode used by @a calcFitness .
+	*/
+	EvalMode getMode() const { return this->mode; }
+
+	/*! @brief			Check if swapping two nodes changes the fitness of their sub paths.
+	*   @param same_path	If both nodes are in the same sub path.
+	*   @return			False only for a swap inside one sub path in the greedy mode, which keeps its node set.
+	*/
+	bool swapChangesScore(bool same_path) const { return !same_path || this->mode == EvalMode::ORDERED; }
+
+	/*! @brief		      Calculate the fitness of one sub path.
+	*
+	*   The PDV visits the nodes of @a idx_list greedily (nearest first) in the
+	*   @a EvalMode::GREEDY mode, or exactly in the given order in the
+	*   @a EvalMode::ORDERED mode. It recharges each center node through IPT and
+	*   its neighbours through acoustic transfer.
+	*   Related formula: Fitness M = alpha * tanh(E_{wsn}) + gamma * inv_tanh(E_{pdv})
+	*
+	*   @param idx_list	A index vector of sensor nodes in the sub path.
+	*   @return			The fitness metric value, -1000 if the sub path is infeasible.
+	*/
+	double calcFitness(const std::vector<int>& idx_list) const;
+
+	/*! @brief			Calculate the fitness of one sub path with caller-owned buffers.
+	*
+	*   The evaluator itself is read-only, so threads may call this concurrently
+	*   as long as each one passes its own @a scratch .
+	*
+	*   @param idx_list	A index vector of sensor nodes in the sub path.
+	*   @param scratch	Working buffers of the calling thread.
+	*   @return			The fitness metric value, -1000 if the sub path is infeasible.
+	*/
+	double calcFitness(const std::vector<int>& idx_list, EvalScratch& scratch) const;
+
+	//! @privatesection
+private:
+	/*! @brief			Score @a idx_list in the given order with a single pass.
+	*   @param idx_list	A index vector of sensor nodes in the sub path.
+	*   @return			The fitness metric value, -1000 if the sub path is infeasible.
+	*/
+	double calcOrderedFitness(const std::vector<int>& idx_list) const;
+
+	/*! @brief			Combine recharged energy and PDV energy into the fitness metric.
+	*   @param charged_eng	Energy recharged to the sensor nodes [J].
+	*   @param total_eng	Maximum energy of the visited center nodes [J].
+	*   @param f_eng		Remaining energy of the PDV [Wh].
+	*   @return			The fitness metric value.
+	*/
+	double calcMetric(const double& charged_eng, const double& total_eng, const double& f_eng) const;
+
+	const SensorFleet<T> fleet;			/*!< Read-only snapshot of all sensor nodes */
+	std::vector<int> cn_idx;			/*!< Index of the first node coincident with each node */
+	AcousGraph<T> acous;				/*!< Acoustic neighbours of every node */
+	std::vector<int> slot_of;			/*!< Slot in @a cost of each node, -1 if not requested */
+	std::vector<NodeCost> cost;			/*!< Cost table of requested nodes */
+	DistOracle<T> oracle;				/*!< Distances between requested nodes and the base station */
+	int coeff_wsn_eng = 50;				/*!< Fitness metric factor for recharged energy */
+	int coeff_pdv_eng = 25;				/*!< Fitness metric factor for PDV energy cost */
+	EvalMode mode = EvalMode::GREEDY;		/*!< How sub paths are ordered */
+};
+
+#endif // !FITNESS_H_
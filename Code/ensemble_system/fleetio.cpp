@@ -0,0 +1,116 @@
+/*! @file fleetio.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include "fleetio.h"
+#include "mappedfile.h"
+
+using namespace std;
+
+//! Skip spaces and tabs.
+static const char* skipBlank(const char* p, const char* end) {
+	while (p < end && (*p == ' ' || *p == '\t')) p++;
+	return p;
+}
+
+//! Parse one csv field and its trailing comma (if @a is_last is false).
+template <class V>
+static bool parseField(const char*& p, const char* end, V& value, bool is_last) {
+	from_chars_result res = from_chars(skipBlank(p, end), end, value);
+	if (res.ec != errc()) return false;
+	p = skipBlank(res.ptr, end);
+	if (is_last) return true;
+	if (p == end || *p != ',') return false;
+	p++;
+	return true;
+}
+
+bool InputFleet::load(const string& fname) {
+	this->clear();
+
+	MappedFile file;
+	try {
+		if (!file.open(fname)) throw runtime_error(fname + ": " + strerror(errno));
+	}
+	catch (const exception& e) {
+		cerr << e.what() << "\n";
+		return false;
+	}
+
+	const char* p = file.data();
+	const char* end = p + file.size();
+	size_t n_lines = count(p, end, '\n');
+	this->xs.reserve(n_lines);
+	this->ys.reserve(n_lines);
+	this->p_types.reserve(n_lines);
+	this->volts.reserve(n_lines);
+	this->weights.reserve(n_lines);
+
+	//! Skip the header line
+	p = find(p, end, '\n');
+	if (p != end) p++;
+
+	int line_num = 1;
+	while (p < end) {
+		line_num++;
+		const char* eol = find(p, end, '\n');
+		const char* q = skipBlank(p, eol);
+		if (q == eol || *q == '\r') {
+			p = (eol == end) ? end : eol + 1;
+			continue;
+		}
+
+		float x = 0.f, y = 0.f, volt = 0.f;
+		int flag = 0, weight = 0;
+		if (!parseField(q, eol, x, false) || !parseField(q, eol, y, false) || !parseField(q, eol, flag, false)
+			|| !parseField(q, eol, volt, false) || !parseField(q, eol, weight, true)) {
+			cerr << fname << ": cannot parse line " << line_num << "\n";
+			this->clear();
+			return false;
+		}
+
+		//! Inputs are in centimetres
+		this->xs.push_back(static_cast<float>(x / 100.));
+		this->ys.push_back(static_cast<float>(y / 100.));
+		this->p_types.push_back(flag != 0);
+		this->volts.push_back(volt);
+		this->weights.push_back(weight);
+
+		p = (eol == end) ? end : eol + 1;
+	}
+
+	return true;
+}
+
+void InputFleet::clear() {
+	this->xs.clear();
+	this->ys.clear();
+	this->p_types.clear();
+	this->volts.clear();
+	this->weights.clear();
+}
+
+template <class T>
+FleetView<T>::FleetView(const InputFleet& input) : nodes(make_shared<vector<SensorNode<T>>>()) {
+	this->nodes->reserve(input.size());
+	for (size_t i = 0; i < input.size(); i++) {
+		this->nodes->push_back(SensorNode<T>(input.xs[i], input.ys[i], input.volts[i], input.weights[i],
+			static_cast<bool>(input.p_types[i])));
+	}
+}
+
+template <class T>
+vector<SensorNode<T>>& FleetView<T>::write() {
+	if (this->nodes.use_count() > 1) this->nodes = make_shared<vector<SensorNode<T>>>(*this->nodes);
+	return *this->nodes;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+/*! @file	fleetio.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "sensornode.h"
+
+#ifndef FLEETIO_H_
+#define FLEETIO_H_
+
+/*! @class		InputFleet fleetio.h "fleetio.h"
+*   @brief		Implementation of @a InputFleet class
+*
+*   The @a InputFleet class holds the columns of one input file
+*   (x_pos, y_pos, p_flag, volts, weights) as flat arrays. @a load maps the
+*   csv file and parses it in place with @c from_chars , so no line or field
+*   strings are created. Positions are stored in metres, as @a SensorNode
+*   expects them.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+class InputFleet
+{
+	//! @publicsection
+public:
+	std::vector<float> xs;			/*!< x coordinates [m] */
+	std::vector<float> ys;			/*!< y coordinates [m] */
+	std::vector<unsigned char> p_types;	/*!< Sensor types, see @a SensorNode::p_sensor_type */
+	std::vector<float> volts;		/*!< Super capacitor voltages [V] */
+	std::vector<int> weights;		/*!< Node weights */
+
+	/*! @brief			Parse an input csv file with a header line.
+	*   @param fname		Path of the file.
+	*   @return			If every line is parsed, return true.
+	*/
+	bool load(const std::string& fname);
+
+	//! Access the number of sensor nodes.
+	size_t size() const { return this->xs.size(); }
+
+	//! Remove all sensor nodes.
+	void clear();
+};
+
+/*! @class		FleetView fleetio.h "fleetio.h"
+*   @brief		Implementation of @a FleetView class
+*
+*   The @a FleetView class is a copy-on-write handle of a sensor node list.
+*   Copies of a view share the same nodes until one of them asks for write
+*   access, which then gets its own copy. A parsed input can therefore be
+*   handed to several algorithms without parsing it again, and each of them
+*   still starts from the original node states.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+template <class T>
+class FleetView
+{
+	//! @publicsection
+public:
+	//! An empty view.
+	FleetView() : nodes(std::make_shared<std::vector<SensorNode<T>>>()) {}
+
+	/*! @brief			Build the sensor nodes of an input once.
+	*   @param input		The parsed input file.
+	*/
+	explicit FleetView(const InputFleet& input);
+
+	//! Read access, never copies.
+	const std::vector<SensorNode<T>>& read() const { return *this->nodes; }
+
+	/*! @brief			Write access, copies the nodes first if they are shared.
+	*   @return			A node list owned by this view only.
+	*/
+	std::vector<SensorNode<T>>& write();
+
+	//! Access the number of sensor nodes.
+	size_t size() const { return this->nodes->size(); }
+
+	//! @privatesection
+private:
+	std::shared_ptr<std::vector<SensorNode<T>>> nodes;	/*!< Node list, possibly shared with other views */
+};
+
+#endif // !FLEETIO_H_
\ No newline at end of file
@@ -0,0 +1,75 @@
+/*! @file flighttrace.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include "flighttrace.h"
+
+using namespace std;
+
+void FlightTrace::enable(const string& fname, Format format) {
+	this->flush();
+	this->enabled = true;
+	this->started = false;
+	this->format = format;
+	this->fname = fname;
+}
+
+void FlightTrace::disable() {
+	this->flush();
+	this->enabled = false;
+}
+
+bool FlightTrace::flush() {
+	if (!this->enabled || this->events.empty()) return true;
+
+	fstream file;
+	fstream::openmode mode = fstream::out | (this->started ? fstream::app : fstream::trunc);
+	if (this->format == Format::BINARY) mode |= fstream::binary;
+	try {
+		file.open(this->fname, mode);
+		if (!file.is_open()) throw runtime_error(this->fname + ": " + strerror(errno));
+	}
+	catch (const exception& e) {
+		cerr << e.what() << "\n";
+		return false;
+	}
+
+	if (this->format == Format::BINARY) {
+		if (!this->started) {
+			uint32_t head[2] = { FLIGHT_TRACE_MAGIC, FLIGHT_TRACE_VERSION };
+			file.write(reinterpret_cast<const char*>(head), sizeof(head));
+		}
+		file.write(reinterpret_cast<const char*>(this->events.data()), this->events.size() * sizeof(Event));
+	}
+	else {
+		string buf;
+		buf.reserve(this->events.size() * 32);
+		if (!this->started) buf += "pdv_id,node_id,time,energy\n";
+		for (const Event& e : this->events) {
+			buf += to_string(e.pdv_id);
+			buf += ',';
+			buf += to_string(e.node_id);
+			buf += ',';
+			buf += to_string(e.time);
+			buf += ',';
+			buf += to_string(e.energy);
+			buf += '\n';
+		}
+		file.write(buf.data(), buf.size());
+	}
+
+	bool is_ok = file.good();
+	file.close();
+	this->started = true;
+	this->events.clear();
+	return is_ok;
+}
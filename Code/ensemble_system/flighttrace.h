@@ -0,0 +1,107 @@
+/*! @file	flighttrace.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef FLIGHTTRACE_H_
+#define FLIGHTTRACE_H_
+
+//! Magic number of the binary trace file ("ODPT")
+#define FLIGHT_TRACE_MAGIC 0x5450444Fu
+//! Version of the binary trace file layout
+#define FLIGHT_TRACE_VERSION 1u
+
+/*! @class		FlightTrace flighttrace.h "flighttrace.h"
+*   @brief		Implementation of @a FlightTrace class
+*
+*   The @a FlightTrace class records the sensor nodes visited in flight
+*   simulations. Every visit (PDV id, node id, flight time, remaining energy)
+*   is kept in memory and written to the sink in one go by @a flush() . The
+*   sink is a csv file or a binary file made of a header (magic, version)
+*   and packed @a Event records. A disabled recorder is a null pointer for
+*   @a PDV::flightSimulation , so it costs nothing in the flight loop.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+class FlightTrace
+{
+	//! @publicsection
+public:
+	//! Sink formats.
+	enum class Format { CSV, BINARY };
+
+	//! One visit of a sensor node.
+	struct Event {
+		int32_t pdv_id;		/*!< PDV id */
+		int32_t node_id;		/*!< Sensor node id */
+		double time;		/*!< Flight time when the node is charged [h] */
+		double energy;		/*!< Remaining PDV energy after charging [Wh] */
+	};
+
+	//! A default constructer, the recorder is disabled.
+	FlightTrace() {}
+
+	//! A destructer which flushes the remaining events.
+	~FlightTrace() { this->flush(); }
+
+	FlightTrace(const FlightTrace&) = delete;
+	FlightTrace& operator=(const FlightTrace&) = delete;
+
+	/*! @brief			Start recording into a sink, which is truncated on the first flush.
+	*   @param fname		Path of the sink file.
+	*   @param format		Format of the sink.
+	*/
+	void enable(const std::string& fname, Format format = Format::CSV);
+
+	//! Flush the remaining events and stop recording.
+	void disable();
+
+	//! Check if visits are recorded.
+	bool isEnabled() const { return this->enabled; }
+
+	/*! @brief			The recorder to hand to @a PDV::flightSimulation .
+	*   @return			This object if it is enabled, otherwise a null pointer.
+	*/
+	FlightTrace* get() { return this->enabled ? this : nullptr; }
+
+	/*! @brief			Buffer one visit.
+	*   @param pdv_id		PDV id.
+	*   @param node_id	Sensor node id.
+	*   @param time		Flight time [h].
+	*   @param energy		Remaining PDV energy [Wh].
+	*/
+	void record(int pdv_id, int node_id, double time, double energy) {
+		this->events.push_back({ pdv_id, node_id, time, energy });
+	}
+
+	/*! @brief			Write the buffered events to the sink and clear the buffer.
+	*   @return			If the events are written (or there is nothing to write), return true.
+	*/
+	bool flush();
+
+	//! Access the number of buffered events.
+	size_t size() const { return this->events.size(); }
+
+	//! @privatesection
+private:
+	bool enabled = false;
+	bool started = false;		/*!< If the sink has been created by a flush */
+	Format format = Format::CSV;
+	std::string fname;
+	std::vector<Event> events;	/*!< Visits not written yet */
+};
+
+#endif // !FLIGHTTRACE_H_
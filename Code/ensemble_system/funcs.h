@@ -1,5 +1,6 @@
 #pragma once
 #include "sensornode.h"
+#include "rng.h"
 
 #ifndef FUNCS_H_
 #define FUNCS_H_
@@ -8,17 +9,23 @@ template <class T>
 class Funcs
 {
 public:
-	Funcs() {};
+	//! Seed from the clock, use the other constructor for reproducible runs.
+	Funcs() : rng(Rng::timeSeed()) {};
+	Funcs(uint64_t seed, uint64_t stream = 0) : rng(seed, stream) {};
 	~Funcs() {};
 	
 	int getRandIndex(int limit);
 	float getRandFloat();
-	double tanhFunc(const double& x);
-	double invTanhFunc(const double& x);
+	Rng& getRng() { return this->rng; }
+	double tanhFunc(const double& x) const;
+	double invTanhFunc(const double& x) const;
 	bool checkDuplicates(std::vector<int> source);
 	void delDuplicates(Cluster<T>& cluster);
 	void delDuplicates(std::vector<Point<T>>& p_list);
 	void delDuplicates(std::vector<int>& idx_list);
+
+private:
+	Rng rng;
 };
 
 
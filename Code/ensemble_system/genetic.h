@@ -12,6 +12,13 @@
 
 #pragma once
 #include "sensornode.h"
+#include "fitness.h"
+#include "rng.h"
+#include "popstore.h"
+#include "guessgen.h"
+#include "threadpool.h"
+#include "convergence.h"
+#include "stoprule.h"
 
 #ifndef GENETIC_H_
 #define GENETIC_H_
@@ -33,7 +40,7 @@ using namespace std;
 *   @copyright	MIT Public License
 */
 template <class T>
-class Genetic : protected SensorNode<T>
+class Genetic
 {
 //! @publicsection
 public:
@@ -42,8 +49,15 @@ public:
 	vector<vector<vector<int>>> trail_int;		/*!< Corresponding trail vector */
 	vector<vector<double>> targets_metric;		/*!< Fitness metric vector of target vector */
 	vector<vector<double>> trails_metric;		/*!< Fitness metric vector of trail vector */
+	vector<vector<bool>> trail_dirty;		/*!< Sub paths of each trail changed since they were scored */
 	vector<Point<T>> req_ps;				/*!< @a Point vector of SNs to be recharged */
+	vector<int> req_idx;				/*!< Index of SNs to be recharged */
 	vector<vector<int>> best_sol;
+	FitnessEval<T>* fit_eval = nullptr;		/*!< Fitness engine of the current planning round */
+	PopStore guess_store;				/*!< Mapped initial guesses of the current case */
+	GuessGen<T>* guess_gen = nullptr;		/*!< Initial solution builder of the current planning round */
+	bool load_guess = false;				/*!< Read the initial population from the case store instead of building it */
+	bool save_guess = false;				/*!< Write the built initial population to the case store */
 
 	double alg_time = 0.;					/*!< Algorithm execution time */
 	int coeff_wsn_eng = 50;
@@ -54,6 +68,18 @@ public:
 	int cr = 50;
 	int min_req_num = 20;
 	int max_num_r = 5;
+	size_t dist_budget = DIST_MEM_BUDGET;		/*!< Memory budget of the distance oracle [bytes] */
+	EvalMode eval_mode = EvalMode::GREEDY;		/*!< How sub paths are ordered when scored */
+	uint64_t seed = 0;					/*!< Seed of all random streams, 0 for a time-based seed */
+	uint64_t used_seed = 0;				/*!< Seed actually used by the last run */
+	Rng rng;						/*!< Main random stream of a run */
+	int n_threads = 0;					/*!< Threads evaluating the population, 0 for all hardware threads */
+	SolverStats stats;					/*!< Phase times and event counts of the last run, filled with ODP_SOLVER_STATS */
+	ConvergenceStream* conv = nullptr;			/*!< Receiver of the per-generation progress, nullptr to stream nothing */
+	StopRule stop_rule;					/*!< Early termination rules, all disabled by default */
+	StopReason stop_reason = StopReason::COMPLETED;	/*!< Why the last run stopped */
+	int steps_run = 0;					/*!< Generations run by the last run */
+	double progress = 0.;					/*!< Share of the planned generations run by the last run [0, 1] */
 
 	//! A default constructer with @a origin (0, 0)
 	Genetic();
@@ -69,35 +95,28 @@ public:
 	*/
 	void initParams(vector<SensorNode<T>*>& req_sn_ptr);
 
-	/*! @brief			Save initial guess to csv file.
-	*   @param pop_num	The number of population in generation.
-	*   @param pdv_num	The number of pdv id.
-	*   @param sn_num		The number of SNs.
-	*   @param path_to_save	The path to be saved.
+	/*! @brief			Save a whole initial guess population to the binary store of a case.
+	*   @param case_num	The case id.
+	*   @param pop_list	Sub paths of every individual.
 	*   @tparam T		The type of data to present point coordinates.
 	*/
-	void saveGuessToTxt(int pop_num, int pdv_num, int sn_num, vector<int> path_to_save);
+	void saveGuessData(int case_num, const vector<vector<vector<int>>>& pop_list);
 
-	/*! @brief			Calculate the minimum required number of needed PDVs.
-	*   @param sn_list	A vector of all sensor nodes.
-	*   @param req_sn_ptr	A vector of pointers to all sensor nodes to be recharged.
-	*   @param temp_req_p	A vector of pointers to all @a Point obejects of sensor nodes to be recharged.
-	*   @tparam T		The type of data to present point coordinates.
-	*   @return			The optimised number of needed PDVs.
-	*/
-	int calcOptPdvNum(vector<SensorNode<T>> sn_list, vector<SensorNode<T>*> req_sn_ptr, vector<Point<T>> temp_req_p);
-
-	/*! @brief			Initialize all target and trail vectors randomly with clusters solution from all sensors
+	/*! @brief			Build the whole initial population in memory.
+	*
+	*   Every individual is built by @a guess_gen in its own task and stream, so
+	*   the population does not depend on the thread count. It is written to the
+	*   case store only if @a save_guess is set.
+	*
+	*   @param case_num	The case id.
 	*   @param r_num		The number of shortest point index.
 	*   @param pdv_num	The number of PDVs.
 	*   @param pop_num	The number of total population.
-	*   @param sn_list	A vector of all sensor nodes.
-	*   @param req_sn_ptr	A vector of pointers to all sensor nodes to be recharged.
-	*   @param req_ps		A vector of @a Point objects of all sensor nodes to be recharged.
+	*   @param pool		Workers building the individuals.
 	*   @tparam T		The type of data to present point coordinates.
 	*   @return			If the number of nodes to be recharged can be divided exactly by @a pdv_num, return true.
 	*/
-	bool calcInitGuess(const int& r_num, const int& pdv_num, const int& pop_num, vector<SensorNode<T>> sn_list, vector<SensorNode<T>*> req_sn_ptr, vector<Point<T>> req_ps);
+	bool calcInitGuess(int case_num, const int& r_num, const int& pdv_num, const int& pop_num, ThreadPool& pool);
 
 	/*! @brief			Implement 'Crossover' and 'Swap Mutation' to generate trail vectors.
 	*   @param cross_ratio 
@@ -105,22 +124,20 @@ public:
 	*   @param is_match	If the number of SNs can be divisible by minimum requireed PDV number.
 	*   @param tar_vec	Target vector.
 	*   @param trail_vec	Trail vector.
-	*   @param sn_list	A vector of all sensor nodes.
 	*   @tparam T		The type of data to present point coordinates.
 	*/
-	void crossover(int cross_ratio, int pop_num, vector<vector<vector<int>>> tar_vec, vector<vector<vector<int>>>& trail_vec, vector<SensorNode<T>> sn_list);
+	void crossover(int cross_ratio, int pop_num, const vector<vector<vector<int>>>& tar_vec, vector<vector<vector<int>>>& trail_vec);
 
 	/*! @brief		      Calculate the fitness of the possible solution.
 	*
 	*   The criteria is based on the amount of recharged energy and the distance of flight.
 	*   Related formula: Fitness M = alpha * tanh(E_{wsn}) + beta * inv_tanh(d_{pdv}) + gamma * inv_tanh(E_{pdv})
 	*
-	*   @param sn_list	A vector of all sensor nodes.
 	*   @param idx_list	A vector of clusters to be calculated (can be one target or trail vector).
 	*   @tparam T		The type of data to present point coordinates.
 	*   @return			The fitness metric value.
 	*/
-	double fitnessFunc(vector<SensorNode<T>> sn_list, vector<int> idx_list);
+	double fitnessFunc(const vector<int>& idx_list);
 
 	/*! @brief			Find the index of the best solution with the highest fitness metric value.
 	*   @param pdv_num	The number of PDVs.
@@ -128,12 +145,12 @@ public:
 	*/
 	int getBestSol(const int& pdv_num);
 
-	/*! @brief			Read the data from stored initial guess
+	/*! @brief			Read one sub path from @a guess_store , which must be opened for the current case.
 	*   @param pop_num	The population id.
 	*   @param pdv_num	The PDV id.
 	*   @return			A vector of solution (index of sensor nodes) with @a pop_num and @a pdv_num
 	*/
-	vector<int> readGuessData(int case_num, int pop_num, int pdv_num);
+	vector<int> readGuessData(int pop_num, int pdv_num);
 
 	/*! @brief			Implement all processes of the genetic algorithm.
 	*
@@ -0,0 +1,97 @@
+/*! @file guessgen.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <algorithm>
+#include <iostream>
+#include "guessgen.h"
+
+using namespace std;
+
+template <class T>
+GuessGen<T>::GuessGen(const DistOracle<T>& oracle, const vector<int>& req_idx) {
+	const int base = oracle.getBase();
+	vector<int> slots(req_idx.size());
+	for (unsigned i = 0; i < slots.size(); i++) slots[i] = i;
+	stable_sort(slots.begin(), slots.end(), [&oracle, base](int a, int b) {
+		return oracle.dist(base, a) < oracle.dist(base, b);
+	});
+
+	this->order.resize(slots.size());
+	this->order_d.resize(slots.size());
+	for (unsigned i = 0; i < slots.size(); i++) {
+		this->order[i] = req_idx[slots[i]];
+		this->order_d[i] = oracle.dist(base, slots[i]);
+	}
+}
+
+template <class T>
+void GuessGen<T>::buildOne(int r_num, int pdv_num, Rng& rng, vector<vector<int>>& idx_list) const {
+	int len = this->order.size();
+	int len_sub_path = len / pdv_num;
+	vector<char> taken(len, 0);
+	int head = 0, picked = 0;
+
+	idx_list.resize(pdv_num);
+	for (int j = 0; j < pdv_num; j++) {
+		//! If not divisible, the last PDV takes all remaining nodes
+		int sub_len = (j == pdv_num - 1) ? len - picked : len_sub_path;
+		idx_list[j].clear();
+		idx_list[j].reserve(sub_len);
+
+		for (int k = 0; k < sub_len; k++) {
+			//! Find the index randomly (the `num`th shortest)
+			int num = 0;
+			int temp_size = len - picked;
+			if (temp_size > r_num) num = rng.uniformInt(r_num - 1);
+			else num = rng.uniformInt(temp_size - 1);
+
+			while (taken[head]) head++;
+			int next = head;
+			for (int c = 0; c < num; c++) {
+				do next++; while (taken[next]);
+			}
+
+			//! Equal distances resolve to the first remaining node
+			for (int z = next - 1; z >= head; z--) {
+				if (taken[z]) continue;
+				if (this->order_d[z] != this->order_d[next]) break;
+				next = z;
+			}
+
+			taken[next] = 1;
+			picked++;
+			idx_list[j].push_back(this->order[next]);
+		}
+	}
+}
+
+template <class T>
+bool GuessGen<T>::loadCase(PopStore& store, int case_num, int pop_num, int pdv_num,
+	vector<vector<vector<int>>>& pop_list) const {
+	if (!store.openCase(case_num, pop_num, pdv_num)) return false;
+
+	vector<int> req(this->order);
+	sort(req.begin(), req.end());
+
+	bool valid = true;
+	vector<int> member;
+	for (int i = 0; i < pop_num && valid; i++) {
+		pop_list[i].resize(pdv_num);
+		member.clear();
+		for (int j = 0; j < pdv_num; j++) {
+			pop_list[i][j] = store.readPath(i, j);
+			member.insert(member.end(), pop_list[i][j].begin(), pop_list[i][j].end());
+		}
+		sort(member.begin(), member.end());
+		valid = member == req;
+	}
+	store.close();
+
+	if (!valid) cerr << "initial guesses of case " << case_num << " do not match the requests, rebuilding them\n";
+	return valid;
+}
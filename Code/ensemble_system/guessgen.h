@@ -0,0 +1,95 @@
+/*! @file	guessgen.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "distoracle.h"
+#include "popstore.h"
+#include "rng.h"
+
+#ifndef GUESSGEN_H_
+#define GUESSGEN_H_
+
+//! Key of the random streams used for the initial population
+#define GUESS_STREAM 0x4755455353ull
+
+/*! @class		GuessGen guessgen.h "guessgen.h"
+*   @brief		Implementation of @a GuessGen class
+*
+*   The @a GuessGen class builds initial-guess solutions with the randomized
+*   r-th nearest construction: every step takes one of the @a r_num requested
+*   nodes closest to the base station, chosen at random, and the sub paths
+*   are filled one after another. The nodes are sorted by their distance to
+*   the base station once, so building one solution costs O(n * r_num)
+*   instead of a sort per step. Ties go to the earlier requested node, as in
+*   the old linear search. A built object is read-only, so several threads
+*   can build solutions at the same time with their own @a Rng .
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+template <class T>
+class GuessGen
+{
+	//! @publicsection
+public:
+	/*! @brief			Sort the requested nodes by their distance to the base station.
+	*   @param oracle		Distance oracle of the requested nodes.
+	*   @param req_idx	Index of the requested nodes in the fleet, in oracle order.
+	*/
+	GuessGen(const DistOracle<T>& oracle, const std::vector<int>& req_idx);
+
+	/*! @brief			Build one solution.
+	*   @param r_num		The number of shortest point index.
+	*   @param pdv_num	The number of PDVs.
+	*   @param rng		The RNG stream of the solution.
+	*   @param idx_list	Output sub paths (sensor node indices), one per PDV.
+	*/
+	void buildOne(int r_num, int pdv_num, Rng& rng, std::vector<std::vector<int>>& idx_list) const;
+
+	/*! @brief			Check if the requested nodes can be divided exactly between the PDVs.
+	*   @param pdv_num	The number of PDVs.
+	*   @return			If the number of nodes can be divided exactly by @a pdv_num, return true.
+	*/
+	bool isMatch(int pdv_num) const { return this->order.size() % pdv_num == 0; }
+
+	/*! @brief			Read the initial population of a case from its store.
+	*
+	*   A store left by another input may hold nodes which are not requested
+	*   now, so every member must cover each requested node exactly once.
+	*   Otherwise the population is rejected and the caller builds a new one.
+	*
+	*   @param store		The store, which is closed again before returning.
+	*   @param case_num	Case id of the run.
+	*   @param pop_num	The number of individuals.
+	*   @param pdv_num	The number of PDVs.
+	*   @param pop_list	Output sub paths (sensor node indices) of every individual.
+	*   @return			If the store can be opened and every member is valid, return true.
+	*/
+	bool loadCase(PopStore& store, int case_num, int pop_num, int pdv_num,
+		std::vector<std::vector<std::vector<int>>>& pop_list) const;
+
+	/*! @brief			The RNG stream of one individual of the initial population.
+	*   @param seed		The per-run seed.
+	*   @param pop_id		The individual id.
+	*   @return			A generator independent of the other individuals and of the solver streams.
+	*/
+	static Rng memberRng(uint64_t seed, int pop_id) { return Rng(seed, Rng::streamId(GUESS_STREAM, pop_id)); }
+
+	//! @privatesection
+private:
+	std::vector<int> order;		/*!< Requested node indices sorted by distance to the base station */
+	std::vector<float> order_d;		/*!< Corresponding distances */
+};
+
+#endif // !GUESSGEN_H_
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "annealing.h"
 #include "pdv.h"
 #include "genetic.h"
+#include "sensorfleet.h"
 
 using namespace std;
 
@@ -27,6 +28,13 @@ void Interface<T>::interfaceInvalid(string message) {
 	system("pause");
 }
 
+template <class T>
+void Interface<T>::reportStop(StopReason reason, double progress) {
+	if (reason == StopReason::COMPLETED) return;
+	cout	<< ">\t Stopped early (" << stopReasonName(reason) << ") after "
+		<< 100. * progress << " % of the search." << endl << endl;
+}
+
 
 template <class T>
 void Interface<T>::resetParams() {
@@ -195,14 +203,15 @@ void Interface<T>::inputCheck() {
 		<< ">\t Validating input data...";
 	int n_rec = 0;
 
-	for (unsigned i = 0; i < this->sn_list.size() - 1; i++) {
-		for (unsigned j = i + 1; j < this->sn_list.size(); j++) {
-			if (this->sn_list[i].pos.isCoincide(this->sn_list[j].pos)) {
-				interfaceInvalid("Exist duplicates in sensor node deployment !");
-				inputCheck();
-			}
+	PointGrid<T> grid(COINCIDE_TOL, this->sn_list.size());
+	for (unsigned i = 0; i < this->sn_list.size(); i++) {
+		if (!grid.insertUnique(this->sn_list[i].pos)) {
+			interfaceInvalid("Exist duplicates in sensor node deployment !");
+			inputCheck();
 		}
+	}
 
+	for (unsigned i = 0; i < this->sn_list.size() - 1; i++) {
 		if (this->sn_list[i].p_sensor_type) {
 			if (this->sn_list[i].SC_V < 0. || this->sn_list[i].SC_V > vmax_p) {
 				interfaceInvalid("Sensor " + to_string(i + 1) + "\t Pressure sensor voltage out of range!");
@@ -423,6 +432,8 @@ void Interface<T>::interfaceGA(vector<SensorNode<T>>& input_sns) {
 		<< endl << endl;
 
 	Genetic<T>* ga = new Genetic<T>(w_rec, w_pdv, w_dist, gen_num, pop_num, cr_num, rec_num, max_neigh);
+	ga->conv = this->conv.get();
+	ga->stop_rule = this->stop_rule;
 	if (!ga->checkTask(input_sns)) {
 		delete ga;
 		interfaceInvalid("No enough sensor nodes to be recharged !");
@@ -431,6 +442,7 @@ void Interface<T>::interfaceGA(vector<SensorNode<T>>& input_sns) {
 
 	this->opt_sol = ga->best_sol;
 	this->alg_t = ga->alg_time;
+	this->reportStop(ga->stop_reason, ga->progress);
 	delete ga;
 
 	cout << ">\t Done." << endl << endl;
@@ -599,6 +611,8 @@ void Interface<T>::interfaceBH(vector<SensorNode<T>>& input_sns) {
 		<< endl << endl;
 
 	BlackHole<T>* bh = new BlackHole<T>(w_rec, w_pdv, w_dist, gen_num, pop_num, ar_num, rec_num, max_neigh);
+	bh->conv = this->conv.get();
+	bh->stop_rule = this->stop_rule;
 	if (!bh->checkTask(input_sns)) {
 		delete bh;
 		interfaceInvalid("No enough sensor nodes to be recharged !");
@@ -607,6 +621,7 @@ void Interface<T>::interfaceBH(vector<SensorNode<T>>& input_sns) {
 
 	this->opt_sol = bh->best_sol;
 	this->alg_t = bh->alg_time;
+	this->reportStop(bh->stop_reason, bh->progress);
 	delete bh;
 
 	cout << ">\t Done." << endl << endl;
@@ -737,6 +752,8 @@ void Interface<T>::interfaceSA(vector<SensorNode<T>>& input_sns) {
 		<< endl << endl;
 
 	Annealing<T>* sa = new Annealing<T>(w_rec, w_pdv, w_dist, init_temp, min_temp, temp_factor, pop_num, rec_num, max_neigh);
+	sa->conv = this->conv.get();
+	sa->stop_rule = this->stop_rule;
 	if (!sa->checkTask(input_sns)) {
 		delete sa;
 		interfaceInvalid("No enough sensor nodes to be recharged !");
@@ -745,6 +762,7 @@ void Interface<T>::interfaceSA(vector<SensorNode<T>>& input_sns) {
 
 	this->opt_sol = sa->best_sol;
 	this->alg_t = sa->alg_time;
+	this->reportStop(sa->stop_reason, sa->progress);
 	delete sa;
 
 	cout << ">\t Done." << endl << endl;
@@ -869,6 +887,8 @@ void Interface<T>::PdvFlightSimulation(vector<vector<int>> out_paths) {
 		}
 	}
 
+	AcousGraph<T> acous(this->sn_list);
+
 	float* pect_list = new float[n_pdv];
 	double* pdv_eng_cost = new double[n_pdv];
 	double* delta_wsn_eng = new double[n_pdv];
@@ -885,7 +905,8 @@ void Interface<T>::PdvFlightSimulation(vector<vector<int>> out_paths) {
 		unique_ptr<PDV<T>> pdv = make_unique<PDV<T>>();
 		float pect = 0.;
 		if (flag2) {
-			pect = pdv->flightSimulation(delta_wsn_eng[i], flight_time[i], this->sn_list, final_sols[i]);
+			pect = pdv->flightSimulation(delta_wsn_eng[i], flight_time[i], this->sn_list, final_sols[i], acous,
+				false, this->trace.get(), i);
 		}
 		else {
 			pect = pdv->singleStageFlight(delta_wsn_eng[i], flight_time[i], this->sn_list, final_sols[i]);
@@ -895,6 +916,7 @@ void Interface<T>::PdvFlightSimulation(vector<vector<int>> out_paths) {
 		pdv_eng_cost[i] = 187. - pdv->getPdvEnergy();
 		flight_ds[i] = pdv->getPdvDistance();
 	}
+	this->trace.flush();
 
 	double max_t = flight_time[0];
 	for (int i = 1; i < n_pdv; i++) {
@@ -902,13 +924,7 @@ void Interface<T>::PdvFlightSimulation(vector<vector<int>> out_paths) {
 	}
 
 	//! Update all Sensor Energy
-	for (unsigned i = 0; i < this->sn_list.size(); i++) {
-		if (sn_list[i].SC_V > this->sn_list[i].getCriticalVolt()) {
-			this->sn_list[i].updateEnergy(max_t * 3600, sn_list[i].SC_E);
-			this->sn_list[i].updateVolt(sn_list[i].SC_V);
-			this->sn_list[i].updateWeight(sn_list[i].SC_V, sn_list[i].weight);
-		}
-	}
+	SensorFleet<T>::drain(this->sn_list, max_t * 3600);
 
 	cout << endl << endl
 		<< ">\t Flight simulation completed !" 
@@ -3,6 +3,9 @@
 #include <vector>
 #include <iostream>
 #include "sensornode.h"
+#include "flighttrace.h"
+#include "convergence.h"
+#include "stoprule.h"
 
 template <class T>
 class Interface
@@ -12,6 +15,9 @@ public:
 	std::vector<std::vector<int>> opt_sol;
 	double alg_t = 0.;
 	int n_alg = -1;
+	FlightTrace trace;		/*!< Recorder of the simulated flights, disabled by default */
+	ConvergenceStream conv;	/*!< Stream of the per-generation solver progress, disabled by default */
+	StopRule stop_rule;		/*!< Early termination rules passed to every algorithm, disabled by default */
 
 	Interface();
 	~Interface();
@@ -21,6 +27,8 @@ private:
 
 	void interfaceInvalid(std::string message);
 
+	void reportStop(StopReason reason, double progress);
+
 	void interfaceIntro();
 
 	void readInputFromCsv(std::vector<SensorNode<T>>& input_sns);
@@ -0,0 +1,153 @@
+/*! @file knnindex.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "knnindex.h"
+
+using namespace std;
+
+//! Relative margin of the stop test, so rounding cannot hide a point outside the searched rings
+#define KNN_STOP_MARGIN (1. - 1e-5)
+
+template <class T>
+template <class F>
+bool KnnIndex<T>::visitRing(const int& cx, const int& cy, const int& r, F visit) const {
+	bool any_cell = false;
+	for (int gx = cx - r; gx <= cx + r; gx++) {
+		if (gx < 0 || gx >= this->nx) continue;
+		//! Inner columns only touch the top and bottom cells of the ring.
+		int step = (gx == cx - r || gx == cx + r || r == 0) ? 1 : 2 * r;
+		for (int gy = cy - r; gy <= cy + r; gy += step) {
+			if (gy < 0 || gy >= this->ny) continue;
+			any_cell = true;
+			int c = gx * this->ny + gy;
+			if (!this->cell_live[c]) continue;
+			for (int k = this->cell_ptr[c]; k < this->cell_ptr[c + 1]; k++) {
+				if (this->live[this->cell_nodes[k]]) visit(this->cell_nodes[k]);
+			}
+		}
+	}
+	return any_cell;
+}
+
+template <class T>
+void KnnIndex<T>::build(const T* xs, const T* ys, int n) {
+	this->n = n;
+	this->live_num = n;
+	this->xs.assign(xs, xs + n);
+	this->ys.assign(ys, ys + n);
+	this->live.assign(n, 1);
+	this->cell_of.resize(n);
+
+	if (!n) {
+		this->nx = this->ny = 0;
+		this->cell_ptr.assign(1, 0);
+		this->cell_nodes.clear();
+		this->cell_live.clear();
+		return;
+	}
+
+	double max_x = *max_element(xs, xs + n), max_y = *max_element(ys, ys + n);
+	this->min_x = *min_element(xs, xs + n);
+	this->min_y = *min_element(ys, ys + n);
+
+	//! About two points per cell on average.
+	this->cell = sqrt(2. * (max_x - this->min_x) * (max_y - this->min_y) / n);
+	this->cell = max(this->cell, max(max_x - this->min_x, max_y - this->min_y) / n);
+	if (this->cell <= 0.) this->cell = 1.;
+	this->nx = static_cast<int>((max_x - this->min_x) / this->cell) + 1;
+	this->ny = static_cast<int>((max_y - this->min_y) / this->cell) + 1;
+
+	this->cell_ptr.assign(static_cast<size_t>(this->nx) * this->ny + 1, 0);
+	for (int i = 0; i < n; i++) {
+		int cx = this->clampCell(xs[i], this->min_x, this->nx);
+		int cy = this->clampCell(ys[i], this->min_y, this->ny);
+		this->cell_of[i] = cx * this->ny + cy;
+		this->cell_ptr[this->cell_of[i] + 1]++;
+	}
+	for (int c = 0; c < this->nx * this->ny; c++) this->cell_ptr[c + 1] += this->cell_ptr[c];
+
+	this->cell_live.resize(static_cast<size_t>(this->nx) * this->ny);
+	for (int c = 0; c < this->nx * this->ny; c++) this->cell_live[c] = this->cell_ptr[c + 1] - this->cell_ptr[c];
+
+	this->cell_nodes.resize(n);
+	vector<int> fill(this->cell_ptr.begin(), this->cell_ptr.end() - 1);
+	for (int i = 0; i < n; i++) this->cell_nodes[fill[this->cell_of[i]]++] = i;
+}
+
+template <class T>
+void KnnIndex<T>::remove(const int& id) {
+	if (!this->live[id]) return;
+	this->live[id] = 0;
+	this->cell_live[this->cell_of[id]]--;
+	this->live_num--;
+}
+
+template <class T>
+void KnnIndex<T>::restore(const int& id) {
+	if (this->live[id]) return;
+	this->live[id] = 1;
+	this->cell_live[this->cell_of[id]]++;
+	this->live_num++;
+}
+
+template <class T>
+int KnnIndex<T>::clampCell(const double& v, const double& lo, const int& num) const {
+	double c = floor((v - lo) / this->cell);
+	if (c < 0.) return 0;
+	if (c >= num) return num - 1;
+	return static_cast<int>(c);
+}
+
+template <class T>
+int KnnIndex<T>::nearest(const T& qx, const T& qy) const {
+	if (!this->live_num) return -1;
+
+	int cx = this->clampCell(qx, this->min_x, this->nx);
+	int cy = this->clampCell(qy, this->min_y, this->ny);
+	int best = -1;
+	T best_d = 0;
+	auto visit = [this, &qx, &qy, &best, &best_d](int id) {
+		T d = this->sqDist(id, qx, qy);
+		if (best < 0 || d < best_d || (d == best_d && id < best)) {
+			best_d = d;
+			best = id;
+		}
+	};
+
+	for (int r = 0; this->visitRing(cx, cy, r, visit); r++) {
+		//! Points outside ring r are at least r cells away.
+		double lim = r * this->cell;
+		if (best >= 0 && best_d < lim * lim * KNN_STOP_MARGIN) break;
+	}
+	return best;
+}
+
+template <class T>
+void KnnIndex<T>::query(const T& qx, const T& qy, const int& k, vector<int>& out) const {
+	out.clear();
+	if (k <= 0 || !this->live_num) return;
+
+	int cx = this->clampCell(qx, this->min_x, this->nx);
+	int cy = this->clampCell(qy, this->min_y, this->ny);
+	vector<pair<T, int>> found;
+	auto visit = [this, &qx, &qy, &found](int id) { found.push_back(make_pair(this->sqDist(id, qx, qy), id)); };
+
+	for (int r = 0; this->visitRing(cx, cy, r, visit); r++) {
+		if (static_cast<int>(found.size()) < k) continue;
+		nth_element(found.begin(), found.begin() + k - 1, found.end());
+		double lim = r * this->cell;
+		if (found[k - 1].first < lim * lim * KNN_STOP_MARGIN) break;
+	}
+
+	int keep = min(k, static_cast<int>(found.size()));
+	partial_sort(found.begin(), found.begin() + keep, found.end());
+	out.resize(keep);
+	for (int i = 0; i < keep; i++) out[i] = found[i].second;
+}
@@ -0,0 +1,115 @@
+/*! @file	knnindex.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <utility>
+#include <vector>
+
+#ifndef KNNINDEX_H_
+#define KNNINDEX_H_
+
+/*! @class		KnnIndex knnindex.h "knnindex.h"
+*   @brief		Implementation of @a KnnIndex class
+*
+*   The @a KnnIndex class answers k-nearest-neighbour queries over a fixed
+*   set of points with a uniform grid of about two points per cell. Cells
+*   are searched ring by ring around the query until no closer point can be
+*   outside, so a query costs O(k) on average instead of a sort over all
+*   points. Points can be removed (and restored), and removed points are
+*   skipped by later queries. Points are ranked by their squared distance
+*   computed as in @a nearestIndex , ties go to the lower id.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+template <class T>
+class KnnIndex
+{
+	//! @publicsection
+public:
+	//! An empty index.
+	KnnIndex() {}
+
+	/*! @brief			Index the first @a n points of @a xs , @a ys .
+	*   @param xs		x coordinates.
+	*   @param ys		y coordinates.
+	*   @param n		Number of points, ids are 0 to @a n - 1.
+	*/
+	KnnIndex(const T* xs, const T* ys, int n) { this->build(xs, ys, n); }
+
+	/*! @brief			(Re-)build the index, all points are live.
+	*   @param xs		x coordinates.
+	*   @param ys		y coordinates.
+	*   @param n		Number of points, ids are 0 to @a n - 1.
+	*/
+	void build(const T* xs, const T* ys, int n);
+
+	//! Skip point @a id in later queries.
+	void remove(const int& id);
+
+	//! Make a removed point @a id live again.
+	void restore(const int& id);
+
+	//! Check if point @a id is live.
+	bool isLive(const int& id) const { return this->live[id] != 0; }
+
+	//! Access the number of live points.
+	int getLiveNum() const { return this->live_num; }
+
+	/*! @brief			Find the live point nearest to a query.
+	*   @param qx		x coordinate of the query.
+	*   @param qy		y coordinate of the query.
+	*   @return			Id of the nearest live point, the lowest id on ties, -1 if none is live.
+	*/
+	int nearest(const T& qx, const T& qy) const;
+
+	/*! @brief			Find the @a k live points nearest to a query.
+	*   @param qx		x coordinate of the query.
+	*   @param qy		y coordinate of the query.
+	*   @param k		Number of points wanted.
+	*   @param out		Ids of up to @a k points, nearest first.
+	*/
+	void query(const T& qx, const T& qy, const int& k, std::vector<int>& out) const;
+
+	//! @privatesection
+private:
+	int n = 0;
+	int live_num = 0;
+	int nx = 0;					/*!< Cells along x */
+	int ny = 0;					/*!< Cells along y */
+	double min_x = 0.;
+	double min_y = 0.;
+	double cell = 1.;				/*!< Cell width [m] */
+	std::vector<T> xs;
+	std::vector<T> ys;
+	std::vector<int> cell_ptr;			/*!< Start of every cell in @a cell_nodes , plus the end marker */
+	std::vector<int> cell_nodes;			/*!< Point ids sorted by cell, ascending within a cell */
+	std::vector<int> cell_live;			/*!< Live points of every cell */
+	std::vector<int> cell_of;			/*!< Cell of every point */
+	std::vector<char> live;			/*!< If a point is live */
+
+	//! Cell coordinate of @a v clamped into the grid.
+	int clampCell(const double& v, const double& lo, const int& num) const;
+
+	//! Squared distance between point @a id and the query.
+	T sqDist(const int& id, const T& qx, const T& qy) const {
+		T dx = this->xs[id] - qx;
+		T dy = this->ys[id] - qy;
+		return dx * dx + dy * dy;
+	}
+
+	//! Visit the live points of the cells on ring @a r around cell (@a cx , @a cy ); return false if the ring is outside the grid.
+	template <class F>
+	bool visitRing(const int& cx, const int& cy, const int& r, F visit) const;
+};
+
+#endif // !KNNINDEX_H_
@@ -25,12 +25,30 @@
 #include "cases.cpp"
 #include "point.cpp"
 #include "sensornode.cpp"
+#include "sensorfleet.cpp"
 #include "interface.cpp"
 #include "genetic.cpp"
 #include "blackhole.cpp"
 #include "annealing.cpp"
 #include "pdv.cpp"
 #include "funcs.cpp"
+#include "fitness.cpp"
+#include "acousgraph.cpp"
+#include "distoracle.cpp"
+#include "nearest.cpp"
+#include "knnindex.cpp"
+#include "pdvestimator.cpp"
+#include "solverstats.cpp"
+#include "mpmcring.cpp"
+#include "convergence.cpp"
+#include "stoprule.cpp"
+#include "threadpool.cpp"
+#include "rng.cpp"
+#include "mappedfile.cpp"
+#include "popstore.cpp"
+#include "fleetio.cpp"
+#include "guessgen.cpp"
+#include "flighttrace.cpp"
 
 using namespace std;
 
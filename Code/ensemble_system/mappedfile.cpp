@@ -0,0 +1,92 @@
+/*! @file mappedfile.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+bool MappedFile::open(const string& fname) {
+	this->close();
+
+#ifdef _WIN32
+	HANDLE h_file = CreateFileA(fname.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (h_file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER f_size;
+	if (!GetFileSizeEx(h_file, &f_size) || f_size.QuadPart == 0) {
+		CloseHandle(h_file);
+		return false;
+	}
+
+	HANDLE h_map = CreateFileMappingA(h_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (h_map == NULL) {
+		CloseHandle(h_file);
+		return false;
+	}
+
+	const void* view = MapViewOfFile(h_map, FILE_MAP_READ, 0, 0, 0);
+	if (view == NULL) {
+		CloseHandle(h_map);
+		CloseHandle(h_file);
+		return false;
+	}
+
+	this->h_file = h_file;
+	this->h_map = h_map;
+	this->ptr = static_cast<const char*>(view);
+	this->len = static_cast<size_t>(f_size.QuadPart);
+#else
+	int fd = ::open(fname.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	//! The mapping stays valid after the descriptor is closed.
+	::close(fd);
+	if (view == MAP_FAILED) return false;
+
+	this->ptr = static_cast<const char*>(view);
+	this->len = static_cast<size_t>(st.st_size);
+#endif
+
+	return true;
+}
+
+void MappedFile::close() {
+	if (!this->ptr) return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(this->ptr);
+	CloseHandle(static_cast<HANDLE>(this->h_map));
+	CloseHandle(static_cast<HANDLE>(this->h_file));
+	this->h_map = nullptr;
+	this->h_file = nullptr;
+#else
+	munmap(const_cast<char*>(this->ptr), this->len);
+#endif
+
+	this->ptr = nullptr;
+	this->len = 0;
+}
\ No newline at end of file
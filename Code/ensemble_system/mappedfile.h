@@ -0,0 +1,71 @@
+/*! @file	mappedfile.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+/*! @class		MappedFile popstore.h "popstore.h"
+*   @brief		Implementation of @a MappedFile class
+*
+*   The @a MappedFile class maps a whole file read-only into memory, with
+*   @c mmap on POSIX systems and a file mapping object on Windows. The
+*   mapping is released by @a close() or the destructor.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+class MappedFile
+{
+	//! @publicsection
+public:
+	//! A default constructer.
+	MappedFile() {}
+
+	//! A destructer which unmaps the file.
+	~MappedFile() { this->close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/*! @brief			Map a file read-only.
+	*   @param fname		Path of the file.
+	*   @return			If the file is mapped, return true.
+	*/
+	bool open(const std::string& fname);
+
+	//! Unmap the file, no-op if nothing is mapped.
+	void close();
+
+	//! Check if a file is mapped.
+	bool isOpen() const { return this->ptr != nullptr; }
+
+	//! Access the first byte of the mapping.
+	const char* data() const { return this->ptr; }
+
+	//! Access the size of the mapping [bytes].
+	size_t size() const { return this->len; }
+
+	//! @privatesection
+private:
+	const char* ptr = nullptr;		/*!< Start of the mapping */
+	size_t len = 0;			/*!< Size of the mapping */
+#ifdef _WIN32
+	void* h_file = nullptr;			/*!< File handle */
+	void* h_map = nullptr;			/*!< File mapping handle */
+#endif
+};
+
+#endif // !MAPPEDFILE_H_
\ No newline at end of file
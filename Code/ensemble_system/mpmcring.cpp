@@ -0,0 +1,71 @@
+/*! @file mpmcring.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include "mpmcring.h"
+
+using namespace std;
+
+template <class E>
+MpmcRing<E>::MpmcRing(size_t capacity) {
+	size_t n = 2;
+	while (n < capacity) n <<= 1;
+	this->mask = n - 1;
+	this->cells = new Cell[n];
+	for (size_t i = 0; i < n; i++) this->cells[i].seq.store(i, memory_order_relaxed);
+}
+
+template <class E>
+MpmcRing<E>::~MpmcRing() {
+	delete[] this->cells;
+}
+
+template <class E>
+bool MpmcRing<E>::tryPush(const E& e) {
+	size_t pos = this->enq_pos.load(memory_order_relaxed);
+	for (;;) {
+		Cell& cell = this->cells[pos & this->mask];
+		size_t seq = cell.seq.load(memory_order_acquire);
+		ptrdiff_t dif = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos);
+		if (dif == 0) {
+			if (this->enq_pos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+				cell.data = e;
+				cell.seq.store(pos + 1, memory_order_release);
+				return true;
+			}
+		}
+		else if (dif < 0) {
+			return false;			//! The consumer of the last lap has not taken this cell yet
+		}
+		else {
+			pos = this->enq_pos.load(memory_order_relaxed);
+		}
+	}
+}
+
+template <class E>
+bool MpmcRing<E>::tryPop(E& e) {
+	size_t pos = this->deq_pos.load(memory_order_relaxed);
+	for (;;) {
+		Cell& cell = this->cells[pos & this->mask];
+		size_t seq = cell.seq.load(memory_order_acquire);
+		ptrdiff_t dif = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos + 1);
+		if (dif == 0) {
+			if (this->deq_pos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+				e = cell.data;
+				cell.seq.store(pos + this->mask + 1, memory_order_release);
+				return true;
+			}
+		}
+		else if (dif < 0) {
+			return false;			//! No producer has filled this cell yet
+		}
+		else {
+			pos = this->deq_pos.load(memory_order_relaxed);
+		}
+	}
+}
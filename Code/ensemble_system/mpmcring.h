@@ -0,0 +1,81 @@
+/*! @file	mpmcring.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+#ifndef MPMCRING_H_
+#define MPMCRING_H_
+
+//! Assumed cache line size [bytes], keeps the two cursors apart
+#define RING_CACHE_LINE 64
+
+/*! @class		MpmcRing mpmcring.h "mpmcring.h"
+*   @brief		Implementation of @a MpmcRing class
+*
+*   The @a MpmcRing class is a bounded lock-free queue for many producers and
+*   many consumers (D. Vyukov's design). Each cell carries a sequence number
+*   telling whether it is free for the producer of a lap or full for its
+*   consumer, so a push or a pop is one compare-and-swap on its cursor and
+*   never waits on a lock. A full queue makes @a tryPush fail instead of
+*   blocking, and an empty one makes @a tryPop fail.
+*
+*   @tparam E		Element type, default constructible and copyable.
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+template <class E>
+class MpmcRing
+{
+	//! @publicsection
+public:
+	/*! @brief			Allocate the cells.
+	*   @param capacity	Number of cells, rounded up to a power of two (at least 2).
+	*/
+	explicit MpmcRing(size_t capacity);
+
+	//! A default destructer which frees the cells.
+	~MpmcRing();
+
+	MpmcRing(const MpmcRing&) = delete;
+	MpmcRing& operator=(const MpmcRing&) = delete;
+
+	/*! @brief			Append an element.
+	*   @param e		The element.
+	*   @return			False if the queue is full.
+	*/
+	bool tryPush(const E& e);
+
+	/*! @brief			Take the oldest element.
+	*   @param e		The element taken.
+	*   @return			False if the queue is empty.
+	*/
+	bool tryPop(E& e);
+
+	//! Access the number of cells.
+	size_t capacity() const { return this->mask + 1; }
+
+	//! @privatesection
+private:
+	struct Cell {
+		std::atomic<size_t> seq;	/*!< Position a producer (== pos) or consumer (== pos + 1) waits for */
+		E data;
+	};
+
+	Cell* cells = nullptr;
+	size_t mask = 0;
+	alignas(RING_CACHE_LINE) std::atomic<size_t> enq_pos{ 0 };
+	alignas(RING_CACHE_LINE) std::atomic<size_t> deq_pos{ 0 };
+};
+
+#endif // !MPMCRING_H_
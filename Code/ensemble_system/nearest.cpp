@@ -0,0 +1,343 @@
+/*! @file nearest.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "nearest.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NEAREST_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(NEAREST_X86) && (defined(__GNUC__) || defined(__clang__))
+#define NEAREST_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define NEAREST_AVX2_TARGET
+#endif
+
+//! Plain loop, also the tail of the vector kernels.
+template <class V>
+static void nearestScalar(const V* xs, const V* ys, const int* idx, int begin, int n, V qx, V qy, int& best, V& best_d) {
+	for (int k = begin; k < n; k++) {
+		int i = idx ? idx[k] : k;
+		V dx = xs[i] - qx;
+		V dy = ys[i] - qy;
+		V d = dx * dx + dy * dy;
+		if (best < 0 || d < best_d) {
+			best_d = d;
+			best = k;
+		}
+	}
+}
+
+//! The scalar kernel, the fallback on other CPUs and the reference of @a nearestSelfCheck .
+template <class V>
+static int nearestScalarKernel(const V* xs, const V* ys, const int* idx, int n, V qx, V qy) {
+	int best = -1;
+	V best_d = 0;
+	nearestScalar(xs, ys, idx, 0, n, qx, qy, best, best_d);
+	return best;
+}
+
+#ifdef NEAREST_X86
+//! Pick the lane with the smallest distance, the lowest position on ties.
+template <class V, class K>
+static void nearestReduce(const V* lane_d, const K* lane_k, int lanes, int& best, V& best_d) {
+	for (int l = 0; l < lanes; l++) {
+		if (lane_k[l] < 0) continue;
+		int k = static_cast<int>(lane_k[l]);
+		if (best < 0 || lane_d[l] < best_d || (lane_d[l] == best_d && k < best)) {
+			best_d = lane_d[l];
+			best = k;
+		}
+	}
+}
+
+static int nearestSse2(const float* xs, const float* ys, const int* idx, int n, float qx, float qy) {
+	int best = -1;
+	float best_d = 0.f;
+	int k = 0;
+
+	if (n >= 4) {
+		const __m128 vqx = _mm_set1_ps(qx), vqy = _mm_set1_ps(qy);
+		const __m128i step = _mm_set1_epi32(4);
+		__m128i pos = _mm_setr_epi32(0, 1, 2, 3);
+		__m128 min_d = _mm_set1_ps(0.f);
+		__m128i min_k = _mm_set1_epi32(-1);
+		for (; k + 4 <= n; k += 4) {
+			__m128 x, y;
+			if (idx) {
+				x = _mm_setr_ps(xs[idx[k]], xs[idx[k + 1]], xs[idx[k + 2]], xs[idx[k + 3]]);
+				y = _mm_setr_ps(ys[idx[k]], ys[idx[k + 1]], ys[idx[k + 2]], ys[idx[k + 3]]);
+			}
+			else {
+				x = _mm_loadu_ps(xs + k);
+				y = _mm_loadu_ps(ys + k);
+			}
+			__m128 dx = _mm_sub_ps(x, vqx), dy = _mm_sub_ps(y, vqy);
+			__m128 d = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+			//! The first block always wins, later ones only if strictly closer.
+			__m128 lt = k ? _mm_cmplt_ps(d, min_d) : _mm_castsi128_ps(_mm_set1_epi32(-1));
+			min_d = _mm_or_ps(_mm_and_ps(lt, d), _mm_andnot_ps(lt, min_d));
+			__m128i lti = _mm_castps_si128(lt);
+			min_k = _mm_or_si128(_mm_and_si128(lti, pos), _mm_andnot_si128(lti, min_k));
+			pos = _mm_add_epi32(pos, step);
+		}
+		alignas(16) float lane_d[4];
+		alignas(16) int lane_k[4];
+		_mm_store_ps(lane_d, min_d);
+		_mm_store_si128(reinterpret_cast<__m128i*>(lane_k), min_k);
+		nearestReduce(lane_d, lane_k, 4, best, best_d);
+	}
+
+	nearestScalar(xs, ys, idx, k, n, qx, qy, best, best_d);
+	return best;
+}
+
+static int nearestSse2(const double* xs, const double* ys, const int* idx, int n, double qx, double qy) {
+	int best = -1;
+	double best_d = 0.;
+	int k = 0;
+
+	if (n >= 2) {
+		const __m128d vqx = _mm_set1_pd(qx), vqy = _mm_set1_pd(qy);
+		const __m128i step = _mm_set1_epi64x(2);
+		__m128i pos = _mm_set_epi64x(1, 0);
+		__m128d min_d = _mm_set1_pd(0.);
+		__m128i min_k = _mm_set1_epi64x(-1);
+		for (; k + 2 <= n; k += 2) {
+			__m128d x, y;
+			if (idx) {
+				x = _mm_setr_pd(xs[idx[k]], xs[idx[k + 1]]);
+				y = _mm_setr_pd(ys[idx[k]], ys[idx[k + 1]]);
+			}
+			else {
+				x = _mm_loadu_pd(xs + k);
+				y = _mm_loadu_pd(ys + k);
+			}
+			__m128d dx = _mm_sub_pd(x, vqx), dy = _mm_sub_pd(y, vqy);
+			__m128d d = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+			//! The first block always wins, later ones only if strictly closer.
+			__m128d lt = k ? _mm_cmplt_pd(d, min_d) : _mm_castsi128_pd(_mm_set1_epi32(-1));
+			min_d = _mm_or_pd(_mm_and_pd(lt, d), _mm_andnot_pd(lt, min_d));
+			__m128i lti = _mm_castpd_si128(lt);
+			min_k = _mm_or_si128(_mm_and_si128(lti, pos), _mm_andnot_si128(lti, min_k));
+			pos = _mm_add_epi64(pos, step);
+		}
+		alignas(16) double lane_d[2];
+		alignas(16) long long lane_k[2];
+		_mm_store_pd(lane_d, min_d);
+		_mm_store_si128(reinterpret_cast<__m128i*>(lane_k), min_k);
+		nearestReduce(lane_d, lane_k, 2, best, best_d);
+	}
+
+	nearestScalar(xs, ys, idx, k, n, qx, qy, best, best_d);
+	return best;
+}
+
+NEAREST_AVX2_TARGET
+static int nearestAvx2(const float* xs, const float* ys, const int* idx, int n, float qx, float qy) {
+	int best = -1;
+	float best_d = 0.f;
+	int k = 0;
+
+	if (n >= 8) {
+		const __m256 vqx = _mm256_set1_ps(qx), vqy = _mm256_set1_ps(qy);
+		const __m256i step = _mm256_set1_epi32(8);
+		__m256i pos = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		__m256 min_d = _mm256_set1_ps(0.f);
+		__m256i min_k = _mm256_set1_epi32(-1);
+		for (; k + 8 <= n; k += 8) {
+			__m256 x, y;
+			if (idx) {
+				__m256i vi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + k));
+				x = _mm256_i32gather_ps(xs, vi, 4);
+				y = _mm256_i32gather_ps(ys, vi, 4);
+			}
+			else {
+				x = _mm256_loadu_ps(xs + k);
+				y = _mm256_loadu_ps(ys + k);
+			}
+			__m256 dx = _mm256_sub_ps(x, vqx), dy = _mm256_sub_ps(y, vqy);
+			__m256 d = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+			//! The first block always wins, later ones only if strictly closer.
+			__m256 lt = k ? _mm256_cmp_ps(d, min_d, _CMP_LT_OQ) : _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			min_d = _mm256_blendv_ps(min_d, d, lt);
+			min_k = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(min_k), _mm256_castsi256_ps(pos), lt));
+			pos = _mm256_add_epi32(pos, step);
+		}
+		alignas(32) float lane_d[8];
+		alignas(32) int lane_k[8];
+		_mm256_store_ps(lane_d, min_d);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lane_k), min_k);
+		nearestReduce(lane_d, lane_k, 8, best, best_d);
+	}
+
+	nearestScalar(xs, ys, idx, k, n, qx, qy, best, best_d);
+	return best;
+}
+
+NEAREST_AVX2_TARGET
+static int nearestAvx2(const double* xs, const double* ys, const int* idx, int n, double qx, double qy) {
+	int best = -1;
+	double best_d = 0.;
+	int k = 0;
+
+	if (n >= 4) {
+		const __m256d vqx = _mm256_set1_pd(qx), vqy = _mm256_set1_pd(qy);
+		const __m256i step = _mm256_set1_epi64x(4);
+		const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+		__m256i pos = _mm256_setr_epi64x(0, 1, 2, 3);
+		__m256d min_d = _mm256_set1_pd(0.);
+		__m256i min_k = _mm256_set1_epi64x(-1);
+		for (; k + 4 <= n; k += 4) {
+			__m256d x, y;
+			if (idx) {
+				//! The masked gather with a zero source, as the plain one trips -Wmaybe-uninitialized in GCC.
+				__m128i vi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx + k));
+				x = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), xs, vi, all, 8);
+				y = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), ys, vi, all, 8);
+			}
+			else {
+				x = _mm256_loadu_pd(xs + k);
+				y = _mm256_loadu_pd(ys + k);
+			}
+			__m256d dx = _mm256_sub_pd(x, vqx), dy = _mm256_sub_pd(y, vqy);
+			__m256d d = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+			//! The first block always wins, later ones only if strictly closer.
+			__m256d lt = k ? _mm256_cmp_pd(d, min_d, _CMP_LT_OQ) : _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+			min_d = _mm256_blendv_pd(min_d, d, lt);
+			min_k = _mm256_castpd_si256(_mm256_blendv_pd(_mm256_castsi256_pd(min_k), _mm256_castsi256_pd(pos), lt));
+			pos = _mm256_add_epi64(pos, step);
+		}
+		alignas(32) double lane_d[4];
+		alignas(32) long long lane_k[4];
+		_mm256_store_pd(lane_d, min_d);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lane_k), min_k);
+		nearestReduce(lane_d, lane_k, 4, best, best_d);
+	}
+
+	nearestScalar(xs, ys, idx, k, n, qx, qy, best, best_d);
+	return best;
+}
+
+//! Check if the CPU and the OS support AVX2.
+static bool nearestHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) return false;
+	__cpuid(info, 1);
+	bool os_avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28));
+	if (!os_avx || (_xgetbv(0) & 6) != 6) return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+//! One kernel for each coordinate type.
+struct NearestKernels {
+	int (*f)(const float*, const float*, const int*, int, float, float);
+	int (*d)(const double*, const double*, const int*, int, double, double);
+	const char* name;
+};
+
+//! Every kernel set the CPU can run, the best first.
+static std::vector<NearestKernels> nearestAllKernels() {
+	std::vector<NearestKernels> list;
+#ifdef NEAREST_X86
+	if (nearestHasAvx2()) list.push_back({ nearestAvx2, nearestAvx2, "avx2" });
+	list.push_back({ nearestSse2, nearestSse2, "sse2" });
+#endif
+	list.push_back({ nearestScalarKernel<float>, nearestScalarKernel<double>, "scalar" });
+	return list;
+}
+
+//! The kernels, picked once.
+static const NearestKernels& nearestKernels() {
+	static const NearestKernels kernels = nearestAllKernels().front();
+	return kernels;
+}
+
+int nearestIndex(const float* xs, const float* ys, int n, float qx, float qy) {
+	return nearestKernels().f(xs, ys, nullptr, n, qx, qy);
+}
+
+int nearestIndex(const float* xs, const float* ys, const int* idx, int n, float qx, float qy) {
+	return nearestKernels().f(xs, ys, idx, n, qx, qy);
+}
+
+int nearestIndex(const double* xs, const double* ys, int n, double qx, double qy) {
+	return nearestKernels().d(xs, ys, nullptr, n, qx, qy);
+}
+
+int nearestIndex(const double* xs, const double* ys, const int* idx, int n, double qx, double qy) {
+	return nearestKernels().d(xs, ys, idx, n, qx, qy);
+}
+
+const char* nearestKernelName() {
+	return nearestKernels().name;
+}
+
+//! Compare one kernel with the scalar loop, with and without an index list.
+template <class V, class Kernel>
+static int nearestCheckOne(Kernel kernel, const char* name, const std::vector<V>& xs, const std::vector<V>& ys,
+	const std::vector<int>& idx, int n, V qx, V qy) {
+	int n_bad = 0;
+	int want = nearestScalarKernel(xs.data(), ys.data(), nullptr, n, qx, qy);
+	int got = kernel(xs.data(), ys.data(), nullptr, n, qx, qy);
+	if (got != want) {
+		std::cerr << "nearest " << name << " (" << sizeof(V) * 8 << " bit): n=" << n << " got " << got << ", expected " << want << "\n";
+		n_bad++;
+	}
+	want = nearestScalarKernel(xs.data(), ys.data(), idx.data(), n, qx, qy);
+	got = kernel(xs.data(), ys.data(), idx.data(), n, qx, qy);
+	if (got != want) {
+		std::cerr << "nearest " << name << " (" << sizeof(V) * 8 << " bit, index list): n=" << n << " got " << got << ", expected " << want << "\n";
+		n_bad++;
+	}
+	return n_bad;
+}
+
+int nearestSelfCheck(uint64_t seed) {
+	std::mt19937_64 gen(seed);
+	std::uniform_int_distribution<int> coord(-4, 4);
+	const int sizes[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 100, 257 };
+
+	int n_bad = 0;
+	for (const NearestKernels& kernels : nearestAllKernels()) {
+		for (int n : sizes) {
+			for (int trial = 0; trial < 50; trial++) {
+				//! Points and queries on a small integer grid, so ties are common and exact in both types.
+				std::vector<float> fx(n), fy(n);
+				std::vector<double> dx(n), dy(n);
+				for (int i = 0; i < n; i++) {
+					fx[i] = static_cast<float>(dx[i] = coord(gen));
+					fy[i] = static_cast<float>(dy[i] = coord(gen));
+				}
+				//! The index lists repeat and shuffle the points.
+				std::vector<int> idx(n);
+				for (int i = 0; i < n; i++) idx[i] = std::uniform_int_distribution<int>(0, n - 1)(gen);
+				int qx = coord(gen), qy = coord(gen);
+
+				n_bad += nearestCheckOne<float>(kernels.f, kernels.name, fx, fy, idx, n, (float)qx, (float)qy);
+				n_bad += nearestCheckOne<double>(kernels.d, kernels.name, dx, dy, idx, n, (double)qx, (double)qy);
+			}
+		}
+	}
+	return n_bad;
+}
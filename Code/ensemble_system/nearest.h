@@ -0,0 +1,72 @@
+/*! @file	nearest.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <cstdint>
+
+#ifndef NEAREST_H_
+#define NEAREST_H_
+
+/*! @defgroup	NEAREST Nearest point search
+*   @{
+*
+*   Find the point nearest to a query among points stored as separate x and
+*   y arrays, either the first @a n points or the points listed in @a idx .
+*   Squared distances are compared in one pass, so nothing is allocated and
+*   no square root is taken. Ties go to the lowest position. Both the
+*   @c float and the @c double versions run an AVX2 or SSE2 kernel picked at
+*   the first call from the CPU features, or a scalar loop on other CPUs.
+*/
+
+/*! @brief			Nearest of the first @a n points.
+*   @param xs		x coordinates.
+*   @param ys		y coordinates.
+*   @param n		Number of points.
+*   @param qx		x coordinate of the query.
+*   @param qy		y coordinate of the query.
+*   @return			Position of the nearest point, -1 if @a n is 0.
+*/
+int nearestIndex(const float* xs, const float* ys, int n, float qx, float qy);
+
+/*! @brief			Nearest of the points @a xs[idx[k]] , @a ys[idx[k]] , k < @a n .
+*   @param xs		x coordinates.
+*   @param ys		y coordinates.
+*   @param idx		Indices of the candidate points.
+*   @param n		Number of candidates.
+*   @param qx		x coordinate of the query.
+*   @param qy		y coordinate of the query.
+*   @return			Position k in @a idx of the nearest point, -1 if @a n is 0.
+*/
+int nearestIndex(const float* xs, const float* ys, const int* idx, int n, float qx, float qy);
+
+//! @c double version of @a nearestIndex over the first @a n points.
+int nearestIndex(const double* xs, const double* ys, int n, double qx, double qy);
+
+//! @c double version of @a nearestIndex over the points listed in @a idx .
+int nearestIndex(const double* xs, const double* ys, const int* idx, int n, double qx, double qy);
+
+//! Name of the kernel picked for this CPU ("avx2", "sse2" or "scalar").
+const char* nearestKernelName();
+
+/*! @brief			Compare every kernel this CPU can run with the scalar loop.
+*
+*   Random points and queries on a small integer grid make ties common. Both
+*   types are checked, over the first @a n points and over index lists with
+*   repeated entries, for sizes around the vector widths. Mismatches are
+*   written to @c cerr .
+*
+*   @param seed		Seed of the random inputs.
+*   @return			The number of mismatches, 0 if every kernel agrees.
+*/
+int nearestSelfCheck(uint64_t seed);
+
+/*! @} */
+
+#endif // !NEAREST_H_
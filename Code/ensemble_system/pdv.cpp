@@ -12,7 +12,6 @@
 
 
 #include <iostream>
-#include <fstream>
 #include <algorithm>
 #include <cstdlib>
 #include <ctime>
@@ -62,7 +61,11 @@ bool PDV<T>::taskCheck(vector<SensorNode<T>>& sn_list) {
 
 template <class T>
 void PDV<T>::updatePdvStatus(const Point<T>& p) {
-	double temp_d = this->pos.calcDist(p);
+	this->updatePdvStatus(p, this->pos.calcDist(p));
+}
+
+template <class T>
+void PDV<T>::updatePdvStatus(const Point<T>& p, const double& temp_d) {
 	this->f_dist += temp_d;
 	this->f_time += temp_d / this->f_speed;
 	this->f_eng -= this->pdv_power * (this->f_time + 5.6e-3);
@@ -79,38 +82,28 @@ void PDV<T>::iptEnergyCost(const SensorNode<T>& next_sn, double& e) {
 }
 
 template <class T>
-float PDV<T>::flightSimulation(double& charged_e, double& pdv_t, vector<SensorNode<T>>& sn_list, vector<Point<T>>& path) {
+float PDV<T>::flightSimulation(double& charged_e, double& pdv_t, vector<SensorNode<T>>& sn_list, vector<Point<T>>& path,
+		const AcousGraph<T>& acous, bool in_order, FlightTrace* trace, int pdv_id) {
 	int charged = 0;
 	int path_len = path.size();
 	charged_e = 0.;
 	pdv_t = 0.;
 
-	do {			// SJN method
-		vector<double> d_list = this->pos.calcDist(path);
-		int next = distance(d_list.begin(), min_element(d_list.begin(), d_list.end()));
+	PointGrid<T> sn_grid(COINCIDE_TOL, sn_list.size());
+	for (unsigned i = 0; i < sn_list.size(); i++) sn_grid.insert(sn_list[i].pos);
 
-		int this_cn = -1;
-		for (unsigned i = 0; i < sn_list.size(); i++) {
-			if (sn_list[i].pos.isCoincide(path[next])) {
-				this_cn = i;
-				break;
-			}
-		}
-
-		string fname = "../solsol/pop.txt";
+	//! Coordinates of the remaining targets, kept in step with @a path
+	vector<T> xs(path.size()), ys(path.size());
+	for (unsigned i = 0; i < path.size(); i++) {
+		xs[i] = path[i].getX();
+		ys[i] = path[i].getY();
+	}
 
-		fstream file;
-		try {
-			file.open(fname, fstream::app);
-			if (!file.is_open())
-				throw runtime_error(strerror(errno));
-		}
-		catch (const exception& e) {
-			cerr << e.what() << "\n";
-		}
+	do {			// SJN method unless the order is given
+		int next = 0;
+		if (!in_order) next = nearestIndex(xs.data(), ys.data(), xs.size(), this->pos.getX(), this->pos.getY());
 
-		file << this_cn << endl;
-		file.close();
+		int this_cn = sn_grid.findCoincide(path[next]);
 
 		if (this->calcEnergyCost(path[next].calcDist(Point<T>()) / this->f_speed) + 
 			this->calcEnergyCost(this->pos.calcDist(path[next]) / this->f_speed) > this->f_eng) {
@@ -130,44 +123,25 @@ float PDV<T>::flightSimulation(double& charged_e, double& pdv_t, vector<SensorNo
 		sn_list[this_cn].updateVolt(sn_list[this_cn].SC_V);
 		sn_list[this_cn].updateWeight(sn_list[this_cn].SC_V, sn_list[this_cn].weight);
 		charged++;
-
-		unique_ptr<Cluster<T>> clst = make_unique<Cluster<T>>();
-		clst->center = &sn_list[this_cn].pos;
-		clst->contains.clear();
-		clst->contains.push_back(&sn_list[this_cn]);
-		clst->assignEndNodes(sn_list);
+		if (trace) trace->record(pdv_id, this_cn, this->f_time, this->f_eng);
 
 		//! Implement center node acoustic power trannsfer.
-		for (unsigned i = 1; i < clst->contains.size(); i++) {
-			auto this_sn = clst->contains[i] - &sn_list[0];
+		for (int k = acous.rowBegin(this_cn); k < acous.rowEnd(this_cn); k++) {
 			double temp_d = 0., temp_g = 0.;
-			temp_d = sn_list[this_sn].pos.calcDist(*clst->center);
+			temp_d = acous.getDist(k);
 			temp_g = std::exp(-1. * pow(2 * PI * 47500, EFF_ACOUS) * temp_d * ALPHA_MAT);
 			charged_e += EFF_PIEZO * EFF_PIEZO * EFF_ACOUS2DC * temp_g * ACOUS_ENERGY_SEND;
 		}
 
 		path.erase(path.begin() + next);
+		xs.erase(xs.begin() + next);
+		ys.erase(ys.begin() + next);
 	} while (path.size());
 
 	//! Return to home process
 	this->updatePdvStatus(Point<T>());
 	pdv_t = this->f_time;
 
-	string fname = "../solsol/pop.txt";
-
-	fstream file;
-	try {
-		file.open(fname, fstream::app);
-		if (!file.is_open())
-			throw runtime_error(strerror(errno));
-	}
-	catch (const exception& e) {
-		cerr << e.what() << "\n";
-	}
-
-	file << endl << endl << endl;
-	file.close();
-
 	return static_cast <float> ((charged / (float)path_len) * 100);
 }
 
@@ -13,6 +13,9 @@
 
 #pragma once
 #include "sensornode.h"
+#include "acousgraph.h"
+#include "flighttrace.h"
+#include "nearest.h"
 
 #ifndef PDV_H_
 #define PDV_H_
@@ -32,7 +35,7 @@
 *  @copyright	MIT Public License
 */
 template <class T>
-class PDV : protected SensorNode<T>
+class PDV
 {
 	//! @publicsection
 public:
@@ -58,8 +61,17 @@ public:
 	*/
 	bool taskCheck(std::vector<SensorNode<T>>& sn_list);
 
+	/*! @brief			Fly to point @a p and update flight distance, time and energy.
+	*   @param p		The next position.
+	*/
 	void updatePdvStatus(const Point<T>& p);
 
+	/*! @brief			Fly to point @a p whose distance is already known.
+	*   @param p		The next position.
+	*   @param d		Distance between the current position and @a p [m].
+	*/
+	void updatePdvStatus(const Point<T>& p, const double& d);
+
 	/*! @brief			Calculate energy consumption according to power and spent time.
 	*
 	*   Related formula: Energy E = P * t
@@ -117,9 +129,14 @@ public:
 	*   @param pdv_t		Total flight time of the PDV.
 	*   @param sn_list	A vector of all sensor nodes
 	*   @param path		A vector of all points to visit
+	*   @param acous		Acoustic neighbour graph of @a sn_list
+	*   @param in_order	If true, visit @a path in the given order instead of nearest first.
+	*   @param trace		Recorder of the visited nodes, nullptr to record nothing.
+	*   @param pdv_id		PDV id written to @a trace .
 	*   @return			Task achievement percenetage [%]
 	*/
-	float flightSimulation(double& charged_e, double& pdv_t, std::vector<SensorNode<T>>& sn_list, std::vector<Point<T>>& path);
+	float flightSimulation(double& charged_e, double& pdv_t, std::vector<SensorNode<T>>& sn_list, std::vector<Point<T>>& path,
+		const AcousGraph<T>& acous, bool in_order = false, FlightTrace* trace = nullptr, int pdv_id = 0);
 
 	float singleStageFlight(double& charged_e, double& pdv_t, std::vector<SensorNode<T>>& sn_list, std::vector<Point<T>>& path);
 
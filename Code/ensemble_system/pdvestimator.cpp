@@ -0,0 +1,119 @@
+/*! @file pdvestimator.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <cstring>
+#include "pdv.h"
+#include "pdvestimator.h"
+
+using namespace std;
+
+template <class T>
+typename PdvEstimator<T>::Cache& PdvEstimator<T>::getCache() {
+	static Cache cache;
+	return cache;
+}
+
+template <class T>
+int PdvEstimator<T>::estimate(const FitnessEval<T>& fit_eval) {
+	vector<double> key = PdvEstimator<T>::makeKey(fit_eval);
+	uint64_t hash = PdvEstimator<T>::hashKey(key);
+	Cache& cache = PdvEstimator<T>::getCache();
+
+	{
+		lock_guard<mutex> guard(cache.lock);
+		for (const Entry& e : cache.entries) {
+			if (e.hash == hash && e.key == key) return e.pdv_num;
+		}
+	}
+
+	//! Computed outside the lock, two threads may both compute a new set once.
+	int pdv_num = PdvEstimator<T>::calcPdvNum(fit_eval);
+
+	lock_guard<mutex> guard(cache.lock);
+	cache.entries.push_back({ hash, move(key), pdv_num });
+	if (cache.entries.size() > PDV_CACHE_SIZE) cache.entries.pop_front();
+	return pdv_num;
+}
+
+template <class T>
+int PdvEstimator<T>::calcPdvNum(const FitnessEval<T>& fit_eval) {
+	const DistOracle<T>& oracle = fit_eval.getOracle();
+	const int base = oracle.getBase();
+	if (!base) return 1;
+	PDV<T> temp_pdv;
+
+	//! Visited nodes are removed from the index, so each step only searches the nodes left.
+	KnnIndex<T> remain = oracle.getIndex();
+
+	int pdv_num = 1, cur = base;
+	do {
+		if (temp_pdv.f_eng <= 20) {
+			pdv_num++;
+			temp_pdv.resetPdvStatus();
+			cur = base;
+			continue;
+		}
+
+		Point<T> cur_p = oracle.getPoint(cur);
+		int slot = remain.nearest(cur_p.getX(), cur_p.getY());
+		double ipt_eng = fit_eval.getSlotCost(slot).ipt_eng;
+
+		if (temp_pdv.calcEnergyCost(oracle.dist(slot, base) / temp_pdv.getPdvSpeed())
+			+ temp_pdv.calcEnergyCost(oracle.dist(cur, slot) / temp_pdv.getPdvSpeed())
+			+ ipt_eng + 20 > temp_pdv.f_eng) {
+
+			pdv_num++;
+			temp_pdv.resetPdvStatus();
+			cur = base;
+			continue;
+		}
+
+		temp_pdv.updatePdvStatus(oracle.getPoint(slot), oracle.dist(cur, slot));
+		temp_pdv.f_eng -= ipt_eng;
+		cur = slot;
+
+		remain.remove(slot);
+	} while (remain.getLiveNum());
+
+	return pdv_num;
+}
+
+template <class T>
+void PdvEstimator<T>::clearCache() {
+	Cache& cache = PdvEstimator<T>::getCache();
+	lock_guard<mutex> guard(cache.lock);
+	cache.entries.clear();
+}
+
+template <class T>
+vector<double> PdvEstimator<T>::makeKey(const FitnessEval<T>& fit_eval) {
+	const DistOracle<T>& oracle = fit_eval.getOracle();
+	int n = oracle.getBase();
+	vector<double> key(static_cast<size_t>(n) * 3);
+	for (int i = 0; i < n; i++) {
+		Point<T> p = oracle.getPoint(i);
+		key[3 * i] = p.getX();
+		key[3 * i + 1] = p.getY();
+		key[3 * i + 2] = fit_eval.getSlotCost(i).ipt_eng;
+	}
+	return key;
+}
+
+template <class T>
+uint64_t PdvEstimator<T>::hashKey(const vector<double>& key) {
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (double v : key) {
+		uint64_t bits;
+		memcpy(&bits, &v, sizeof(bits));
+		for (int b = 0; b < 8; b++) {
+			hash ^= (bits >> (8 * b)) & 0xff;
+			hash *= 0x100000001b3ull;
+		}
+	}
+	return hash;
+}
@@ -0,0 +1,86 @@
+/*! @file	pdvestimator.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "fitness.h"
+
+#ifndef PDVESTIMATOR_H_
+#define PDVESTIMATOR_H_
+
+//! Number of request sets kept by the fleet-size cache
+#define PDV_CACHE_SIZE 16
+
+/*! @class		PdvEstimator pdvestimator.h "pdvestimator.h"
+*   @brief		Implementation of @a PdvEstimator class
+*
+*   The @a PdvEstimator class estimates how many PDVs a request set needs.
+*   It replays the greedy nearest-first tour: a PDV takes the nearest
+*   remaining node while it can still charge it and fly home with 20 Wh
+*   left, otherwise a new PDV starts from the base station. Nearest nodes
+*   come from the k-NN index of the distance oracle with visited nodes
+*   removed, and IPT costs from the cost table, so one estimate costs about
+*   O(n log n). Results are cached by the positions and IPT costs of the
+*   requested nodes, shared by all optimisers and threads.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+template <class T>
+class PdvEstimator
+{
+	//! @publicsection
+public:
+	/*! @brief			Number of PDVs needed by the requested nodes of @a fit_eval .
+	*   @param fit_eval	Fitness engine built for the current round.
+	*   @return			The optimised number of needed PDVs, from the cache if the same request set was seen.
+	*/
+	static int estimate(const FitnessEval<T>& fit_eval);
+
+	/*! @brief			Run the greedy tour without the cache.
+	*   @param fit_eval	Fitness engine built for the current round.
+	*   @return			The optimised number of needed PDVs.
+	*/
+	static int calcPdvNum(const FitnessEval<T>& fit_eval);
+
+	//! Drop every cached result.
+	static void clearCache();
+
+	//! @privatesection
+private:
+	//! A cached request set and its result.
+	struct Entry {
+		uint64_t hash;			/*!< Hash of @a key */
+		std::vector<double> key;	/*!< x, y and IPT cost of every requested node */
+		int pdv_num;
+	};
+
+	//! Cached request sets of one coordinate type, newest last.
+	struct Cache {
+		std::mutex lock;
+		std::deque<Entry> entries;
+	};
+
+	//! Access the cache shared by all threads.
+	static Cache& getCache();
+
+	//! Fingerprint of the request set of @a fit_eval .
+	static std::vector<double> makeKey(const FitnessEval<T>& fit_eval);
+
+	//! FNV-1a hash of a fingerprint.
+	static uint64_t hashKey(const std::vector<double>& key);
+};
+
+#endif // !PDVESTIMATOR_H_
@@ -12,11 +12,16 @@
 
 
 #pragma once
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 #ifndef POINT_H_
 #define POINT_H_
 
+//! Distance under which two points are the same sensor node [m]
+#define COINCIDE_TOL 1e-2
+
 /*!
 *  @class		Point
 *  @headerfile	point.h "point.h"
@@ -78,7 +83,7 @@ public:
 	*  @tparam T	The type of data used to present point coordinates
 	*  @return		The distance between two points
 	*/
-	double calcDist(const Point<T>& p);
+	double calcDist(const Point<T>& p) const;
 
 	/*! @brief		Calculate the distance between one point and specified @a x and @a y
 	*  @details	Related formula: Distance d = sqrt((x1 - x2)^2 + (y1 + y2)^2)
@@ -87,7 +92,7 @@ public:
 	*  @tparam T	The type of data used to present point coordinates
 	*  @return		The @c float distance
 	*/
-	double calcDist(const float& x, const float& y);
+	double calcDist(const float& x, const float& y) const;
 
 	/*! @brief		Calculate the list of distances between one point and a list of points
 	*  @details	Related formula: Distance d = sqrt((x1 - x2)^2 + (y1 + y2)^2)
@@ -95,23 +100,88 @@ public:
 	*  @tparam T	The type of data used to present point coordinates
 	*  @return		A vector stored distances
 	*/
-	std::vector<double> calcDist(const std::vector<Point<T>>& p_list);
+	std::vector<double> calcDist(const std::vector<Point<T>>& p_list) const;
 
 	/*! @brief		Determine if two points are overlapped
 	*  @param p	A @a Point object with @c T data type
 	*  @tparam T	The type of data used to present point coordinates
 	*  @return		true or false
 	*/
-	bool isCoincide(const Point<T>& p);
+	bool isCoincide(const Point<T>& p) const;
 
 	//! print the point coordiante
 	void printPointLoc();
 
-	//! @protected section
+	//! @protectedsection
 protected:
 	T x_;			/*!< x coordinate (@c float in default)*/
 	T y_;			/*!< y coordinate (@c float in default)*/
 };				//! End of class Point
 
+/*!
+*  @class		PointGrid
+*  @headerfile	point.h "point.h"
+*  @brief		Implementation of @a PointGrid (class)
+*
+*  The @a PointGrid class hashes points into square cells about as wide as the
+*  coincidence tolerance, so a point coinciding with a query can only be in
+*  the 3 x 3 cells around it. Duplicate checks and look-ups then cost O(1) on
+*  average instead of a scan over all points. Points get ids in insertion
+*  order.
+*
+*  @author		Qiuchen Qian
+*  @version	1
+*  @date		2020
+*  @copyright	MIT Public License
+*/
+template <class T>
+class PointGrid
+{
+	//! @publicsection
+public:
+	/*! @brief		Construct an empty grid
+	*  @param tol	The coincidence tolerance, see @a Point::isCoincide
+	*  @param n_hint	Expected number of points
+	*/
+	explicit PointGrid(double tol = COINCIDE_TOL, size_t n_hint = 0);
+
+	/*! @brief		Store a point
+	*  @param p	The point to store
+	*  @return		The id of the point
+	*/
+	int insert(const Point<T>& p);
+
+	/*! @brief		Find a stored point which coincides with @a p
+	*  @param p	The point to look up
+	*  @return		The lowest id of the coincident points, -1 if there is none
+	*/
+	int findCoincide(const Point<T>& p) const;
+
+	/*! @brief		Store a point only if no stored point coincides with it
+	*  @param p	The point to store
+	*  @return		true if @a p is stored, false if it is a duplicate
+	*/
+	bool insertUnique(const Point<T>& p);
+
+	//! Access the number of stored points
+	size_t size() const { return this->pts.size(); }
+
+	//! @protectedsection
+protected:
+	double tol;					/*!< Coincidence tolerance */
+	double cell;					/*!< Cell width, slightly larger than @a tol */
+	std::unordered_map<uint64_t, int> heads;	/*!< Last stored id of every cell */
+	std::vector<int> prev;			/*!< Previous id in the same cell, -1 at the end */
+	std::vector<Point<T>> pts;		/*!< Stored points */
+
+	//! Cell index of one coordinate
+	int64_t cellOf(const T& v) const;
+
+	//! Hash key of a cell
+	static uint64_t cellKey(int64_t cx, int64_t cy) {
+		return (static_cast<uint64_t>(cx) << 32) ^ static_cast<uint32_t>(cy);
+	}
+};				//! End of class PointGrid
+
 #endif // !POINT_H_
 
@@ -0,0 +1,201 @@
+/*! @file popstore.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include "popstore.h"
+
+using namespace std;
+
+bool PopStore::open(const string& fname) {
+	this->close();
+
+	try {
+		if (!this->file.open(fname)) throw runtime_error(fname + ": " + strerror(errno));
+	}
+	catch (const exception& e) {
+		cerr << e.what() << "\n";
+		return false;
+	}
+
+	const char* base = this->file.data();
+	size_t size = this->file.size();
+	Header head;
+	if (size < sizeof(Header)) {
+		cerr << fname << ": truncated population file" << "\n";
+		this->close();
+		return false;
+	}
+	memcpy(&head, base, sizeof(Header));
+	if (head.magic != POP_STORE_MAGIC || head.version != POP_STORE_VERSION || head.pop_num < 0 || head.pdv_num < 0) {
+		cerr << fname << ": not a population file" << "\n";
+		this->close();
+		return false;
+	}
+
+	//! Bound the counts by the file size before multiplying, so a corrupted header cannot wrap them.
+	size_t max_offsets = (size - sizeof(Header)) / sizeof(uint64_t);
+	if (max_offsets == 0 || (head.pdv_num > 0 && static_cast<size_t>(head.pop_num) > (max_offsets - 1) / head.pdv_num)) {
+		cerr << fname << ": truncated population file" << "\n";
+		this->close();
+		return false;
+	}
+	size_t path_num = static_cast<size_t>(head.pop_num) * head.pdv_num;
+	size_t data_begin = sizeof(Header) + (path_num + 1) * sizeof(uint64_t);
+
+	const uint64_t* offsets = reinterpret_cast<const uint64_t*>(base + sizeof(Header));
+	for (size_t i = 0; i < path_num; i++) {
+		if (offsets[i] > offsets[i + 1]) {
+			cerr << fname << ": corrupted offset table" << "\n";
+			this->close();
+			return false;
+		}
+	}
+	if (offsets[0] != 0 || offsets[path_num] > (size - data_begin) / sizeof(int32_t)) {
+		cerr << fname << ": truncated population file" << "\n";
+		this->close();
+		return false;
+	}
+
+	this->pop_num = head.pop_num;
+	this->pdv_num = head.pdv_num;
+	this->offsets = offsets;
+	this->paths = reinterpret_cast<const int32_t*>(base + data_begin);
+
+	return true;
+}
+
+bool PopStore::openCase(int case_num, int pop_num, int pdv_num) {
+	string fname = PopStore::casePath(case_num);
+
+	//! Check the existing file quietly before falling back to the text guesses.
+	MappedFile probe;
+	if (probe.open(fname) && probe.size() >= sizeof(Header)) {
+		Header head;
+		memcpy(&head, probe.data(), sizeof(Header));
+		probe.close();
+		if (head.magic == POP_STORE_MAGIC && head.version == POP_STORE_VERSION
+			&& head.pop_num >= pop_num && head.pdv_num == pdv_num) {
+			return this->open(fname);
+		}
+	}
+	probe.close();
+
+	if (!PopStore::convertTxt(PopStore::caseDir(case_num), pop_num, pdv_num, fname)) return false;
+	return this->open(fname);
+}
+
+void PopStore::close() {
+	this->file.close();
+	this->pop_num = 0;
+	this->pdv_num = 0;
+	this->offsets = nullptr;
+	this->paths = nullptr;
+}
+
+const int32_t* PopStore::getPath(int pop_id, int pdv_id, size_t& len) const {
+	if (pop_id < 0 || pop_id >= this->pop_num || pdv_id < 0 || pdv_id >= this->pdv_num) {
+		len = 0;
+		return nullptr;
+	}
+
+	size_t i = static_cast<size_t>(pop_id) * this->pdv_num + pdv_id;
+	len = static_cast<size_t>(this->offsets[i + 1] - this->offsets[i]);
+	return this->paths + this->offsets[i];
+}
+
+vector<int> PopStore::readPath(int pop_id, int pdv_id) const {
+	size_t len = 0;
+	const int32_t* path = this->getPath(pop_id, pdv_id, len);
+	return vector<int>(path, path + len);
+}
+
+bool PopStore::save(const string& fname, const vector<vector<vector<int>>>& pop_list) {
+	Header head;
+	head.magic = POP_STORE_MAGIC;
+	head.version = POP_STORE_VERSION;
+	head.pop_num = static_cast<int32_t>(pop_list.size());
+	head.pdv_num = pop_list.size() ? static_cast<int32_t>(pop_list[0].size()) : 0;
+
+	vector<uint64_t> offsets(1, 0);
+	offsets.reserve(static_cast<size_t>(head.pop_num) * head.pdv_num + 1);
+	for (unsigned i = 0; i < pop_list.size(); i++) {
+		if (static_cast<int32_t>(pop_list[i].size()) != head.pdv_num) {
+			cerr << fname << ": individuals have different PDV numbers" << "\n";
+			return false;
+		}
+		for (unsigned j = 0; j < pop_list[i].size(); j++) offsets.push_back(offsets.back() + pop_list[i][j].size());
+	}
+
+	fstream file;
+	try {
+		file.open(fname, fstream::out | fstream::binary | fstream::trunc);
+		if (!file.is_open()) throw runtime_error(fname + ": " + strerror(errno));
+	}
+	catch (const exception& e) {
+		cerr << e.what() << "\n";
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(&head), sizeof(Header));
+	file.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+	vector<int32_t> buf;
+	for (unsigned i = 0; i < pop_list.size(); i++) {
+		for (unsigned j = 0; j < pop_list[i].size(); j++) {
+			buf.assign(pop_list[i][j].begin(), pop_list[i][j].end());
+			file.write(reinterpret_cast<const char*>(buf.data()), buf.size() * sizeof(int32_t));
+		}
+	}
+
+	bool is_ok = file.good();
+	file.close();
+	return is_ok;
+}
+
+bool PopStore::convertTxt(const string& txt_dir, int pop_num, int pdv_num, const string& fname) {
+	vector<vector<vector<int>>> pop_list(pop_num, vector<vector<int>>(pdv_num));
+
+	for (int i = 0; i < pop_num; i++) {
+		for (int j = 0; j < pdv_num; j++) {
+			string txt_name = txt_dir + "/pop" + to_string(i) + "pdv" + to_string(j) + ".txt";
+			fstream file;
+			try {
+				file.open(txt_name, fstream::in);
+				if (!file.is_open()) throw runtime_error(txt_name + ": " + strerror(errno));
+			}
+			catch (const exception& e) {
+				cerr << e.what() << "\n";
+				return false;
+			}
+
+			string line;
+			getline(file, line);
+			file.close();
+
+			stringstream ss(line);
+			for (int k; ss >> k;) {
+				pop_list[i][j].push_back(k);
+				if (ss.peek() == ',') ss.ignore();
+			}
+		}
+	}
+
+	return PopStore::save(fname, pop_list);
+}
+
+string PopStore::caseDir(int case_num) {
+	return "../input/initial_guess/case" + to_string(case_num);
+}
+
+string PopStore::casePath(int case_num) {
+	return PopStore::caseDir(case_num) + "/pop.bin";
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+/*! @file	popstore.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "mappedfile.h"
+
+#ifndef POPSTORE_H_
+#define POPSTORE_H_
+
+//! Magic number of the binary population file ("ODPP")
+#define POP_STORE_MAGIC 0x5050444Fu
+//! Version of the binary population file layout
+#define POP_STORE_VERSION 1u
+
+/*! @class		PopStore popstore.h "popstore.h"
+*   @brief		Implementation of @a PopStore class
+*
+*   The @a PopStore class keeps a whole initial-guess population of one case
+*   in a single binary file: a header (magic, version, population size, PDV
+*   number), an offset table with one entry per (individual, PDV) plus an end
+*   marker, and the packed @c int32 sensor node indices of all sub paths. The
+*   file is memory mapped, so a sub path is read in place without parsing.
+*   @a convertTxt turns the old per-file text layout
+*   (pop<i>pdv<j>.txt, comma separated) into this format.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+class PopStore
+{
+	//! @publicsection
+public:
+	//! A default constructer.
+	PopStore() {}
+
+	/*! @brief			Map a binary population file and check its layout.
+	*   @param fname		Path of the file.
+	*   @return			If the file is valid, return true.
+	*/
+	bool open(const std::string& fname);
+
+	/*! @brief			Open the population of a case, converting the text guesses first if needed.
+	*
+	*   If the binary file of @a case_num is missing or smaller than @a pop_num
+	*   x @a pdv_num , it is rebuilt from the text files in the same folder.
+	*
+	*   @param case_num	The case id.
+	*   @param pop_num	Number of individuals needed.
+	*   @param pdv_num	Number of PDVs (sub paths per individual).
+	*   @return			If the population is available, return true.
+	*/
+	bool openCase(int case_num, int pop_num, int pdv_num);
+
+	//! Unmap the file.
+	void close();
+
+	//! Check if a population is mapped.
+	bool isOpen() const { return this->file.isOpen(); }
+
+	//! Access the number of individuals.
+	int getPopNum() const { return this->pop_num; }
+
+	//! Access the number of PDVs per individual.
+	int getPdvNum() const { return this->pdv_num; }
+
+	/*! @brief			Access one sub path in place.
+	*   @param pop_id		The individual id.
+	*   @param pdv_id		The PDV id.
+	*   @param len		Number of sensor node indices of the sub path.
+	*   @return			Pointer to the first index, valid while the store is open.
+	*/
+	const int32_t* getPath(int pop_id, int pdv_id, size_t& len) const;
+
+	/*! @brief			Copy one sub path.
+	*   @param pop_id		The individual id.
+	*   @param pdv_id		The PDV id.
+	*   @return			Sensor node indices of the sub path, empty if it does not exist.
+	*/
+	std::vector<int> readPath(int pop_id, int pdv_id) const;
+
+	/*! @brief			Write a population to a binary file.
+	*   @param fname		Path of the file.
+	*   @param pop_list	Sub paths of every individual, all with the same PDV number.
+	*   @return			If the file is written, return true.
+	*/
+	static bool save(const std::string& fname, const std::vector<std::vector<std::vector<int>>>& pop_list);
+
+	/*! @brief			Convert text guesses pop<i>pdv<j>.txt into a binary file.
+	*   @param txt_dir	Folder of the text files.
+	*   @param pop_num	Number of individuals.
+	*   @param pdv_num	Number of PDVs.
+	*   @param fname		Path of the binary file.
+	*   @return			If every text file is read and the binary file is written, return true.
+	*/
+	static bool convertTxt(const std::string& txt_dir, int pop_num, int pdv_num, const std::string& fname);
+
+	//! Folder of the initial guesses of a case.
+	static std::string caseDir(int case_num);
+
+	//! Path of the binary population file of a case.
+	static std::string casePath(int case_num);
+
+	//! @privatesection
+private:
+	MappedFile file;			/*!< Mapping of the binary file */
+	int pop_num = 0;
+	int pdv_num = 0;
+	const uint64_t* offsets = nullptr;	/*!< Start of every sub path in @a paths , plus the end marker */
+	const int32_t* paths = nullptr;		/*!< Packed sensor node indices */
+
+	//! Header of the binary file.
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		int32_t pop_num;
+		int32_t pdv_num;
+	};
+};
+
+#endif // !POPSTORE_H_
\ No newline at end of file
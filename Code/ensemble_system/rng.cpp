@@ -0,0 +1,59 @@
+/*! @file rng.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <chrono>
+#include "rng.h"
+
+using namespace std;
+
+uint64_t Rng::splitMix(uint64_t& x) {
+	uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+void Rng::seed(uint64_t seed, uint64_t stream) {
+	//! Mix the stream id first, so neighbouring ids give unrelated states.
+	uint64_t key = stream;
+	uint64_t x = seed ^ splitMix(key);
+	for (int i = 0; i < 4; i++) this->s[i] = splitMix(x);
+}
+
+uint64_t Rng::streamId(uint64_t a, uint64_t b) {
+	uint64_t x = a;
+	return splitMix(x) ^ b;
+}
+
+uint64_t Rng::timeSeed() {
+	return static_cast<uint64_t>(chrono::high_resolution_clock::now().time_since_epoch().count());
+}
+
+void Rng::jump() {
+	static const uint64_t JUMP[] = { 0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull,
+		0xa9582618e03fc9aaull, 0x39abdc4529b1661cull };
+
+	uint64_t t[4] = { 0, 0, 0, 0 };
+	for (int i = 0; i < 4; i++) {
+		for (int b = 0; b < 64; b++) {
+			if (JUMP[i] & (1ull << b)) {
+				for (int k = 0; k < 4; k++) t[k] ^= this->s[k];
+			}
+			this->next();
+		}
+	}
+	for (int k = 0; k < 4; k++) this->s[k] = t[k];
+}
+
+void Rng::fillInt(int* out, size_t n, int limit) {
+	for (size_t i = 0; i < n; i++) out[i] = this->uniformInt(limit);
+}
+
+void Rng::fillFloat(float* out, size_t n) {
+	for (size_t i = 0; i < n; i++) out[i] = this->uniformFloat();
+}
\ No newline at end of file
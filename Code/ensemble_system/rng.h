@@ -0,0 +1,121 @@
+/*! @file	rng.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#ifndef RNG_H_
+#define RNG_H_
+
+/*! @class		Rng rng.h "rng.h"
+*   @brief		Implementation of @a Rng class
+*
+*   The @a Rng class is a xoshiro256** generator. Its state is seeded from a
+*   (seed, stream) pair through splitmix64, so every thread, chain or star can
+*   own an independent stream derived from one per-run seed, and the same
+*   seed always reproduces the same numbers. An object must not be shared
+*   between threads.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+class Rng
+{
+	//! @publicsection
+public:
+	/*! @brief			Seed the generator.
+	*   @param seed		The per-run seed.
+	*   @param stream		Id of the stream derived from @a seed .
+	*/
+	explicit Rng(uint64_t seed = 0, uint64_t stream = 0) { this->seed(seed, stream); }
+
+	/*! @brief			Re-seed the generator.
+	*   @param seed		The per-run seed.
+	*   @param stream		Id of the stream derived from @a seed .
+	*/
+	void seed(uint64_t seed, uint64_t stream = 0);
+
+	/*! @brief			Combine two keys into one stream id, e.g. (generation, star).
+	*   @param a		The first key.
+	*   @param b		The second key.
+	*   @return			The stream id.
+	*/
+	static uint64_t streamId(uint64_t a, uint64_t b);
+
+	/*! @brief			Time-based seed for runs without an explicit one.
+	*   @return			A seed taken from the high resolution clock.
+	*/
+	static uint64_t timeSeed();
+
+	/*! @brief			Advance the state by 2^128 steps, giving a non-overlapping sub-stream.
+	*/
+	void jump();
+
+	//! Next raw 64-bit output.
+	uint64_t next() {
+		const uint64_t result = rotl(this->s[1] * 5, 7) * 9;
+		const uint64_t t = this->s[1] << 17;
+		this->s[2] ^= this->s[0];
+		this->s[3] ^= this->s[1];
+		this->s[1] ^= this->s[2];
+		this->s[0] ^= this->s[3];
+		this->s[2] ^= t;
+		this->s[3] = rotl(this->s[3], 45);
+		return result;
+	}
+
+	/*! @brief			Uniform integer without modulo bias.
+	*   @param limit		The upper bound, inclusive.
+	*   @return			A value in [0, @a limit ], 0 if @a limit is negative.
+	*/
+	int uniformInt(int limit) {
+		if (limit <= 0) return 0;
+		const uint64_t range = static_cast<uint64_t>(limit) + 1;
+		uint64_t m = (this->next() >> 32) * range;
+		if (static_cast<uint32_t>(m) < range) {
+			const uint32_t thresh = static_cast<uint32_t>(-static_cast<uint32_t>(range) % static_cast<uint32_t>(range));
+			while (static_cast<uint32_t>(m) < thresh) m = (this->next() >> 32) * range;
+		}
+		return static_cast<int>(m >> 32);
+	}
+
+	//! Uniform float in [0, 1).
+	float uniformFloat() { return static_cast<float>(this->next() >> 40) * (1.f / 16777216.f); }
+
+	//! Uniform double in [0, 1).
+	double uniformDouble() { return static_cast<double>(this->next() >> 11) * (1. / 9007199254740992.); }
+
+	/*! @brief			Fill a buffer with uniform integers.
+	*   @param out		The buffer.
+	*   @param n		Number of values.
+	*   @param limit		The upper bound, inclusive.
+	*/
+	void fillInt(int* out, size_t n, int limit);
+
+	/*! @brief			Fill a buffer with uniform floats in [0, 1).
+	*   @param out		The buffer.
+	*   @param n		Number of values.
+	*/
+	void fillFloat(float* out, size_t n);
+
+	//! @privatesection
+private:
+	uint64_t s[4];			/*!< Generator state */
+
+	static uint64_t rotl(const uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+	//! One splitmix64 step, used for seeding and key mixing.
+	static uint64_t splitMix(uint64_t& x);
+};
+
+#endif // !RNG_H_
\ No newline at end of file
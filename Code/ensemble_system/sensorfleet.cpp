@@ -0,0 +1,55 @@
+/*! @file sensorfleet.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <cmath>
+#include "sensorfleet.h"
+
+using namespace std;
+
+template <class T>
+void SensorFleet<T>::assign(const vector<SensorNode<T>>& sn_list) {
+	size_t n = sn_list.size();
+	this->xs.resize(n);
+	this->ys.resize(n);
+	this->sc_v.resize(n);
+	this->sc_e.resize(n);
+	this->weights.resize(n);
+	this->types.resize(n);
+
+	for (size_t i = 0; i < n; i++) {
+		this->xs[i] = sn_list[i].pos.getX();
+		this->ys[i] = sn_list[i].pos.getY();
+		this->sc_v[i] = sn_list[i].SC_V;
+		this->sc_e[i] = sn_list[i].SC_E;
+		this->weights[i] = sn_list[i].weight;
+		this->types[i] = static_cast<uint8_t>(sn_list[i].getTypeId());
+	}
+}
+
+template <class T>
+SensorNode<T> SensorFleet<T>::node(size_t i) const {
+	SensorNode<T> sn(this->xs[i], this->ys[i], this->sc_v[i], this->weights[i], this->types[i] == P_SENSOR_TYPE);
+	//! The constructor takes float coordinates, so the position is set again at full precision.
+	sn.pos = this->getPos(i);
+	sn.SC_E = this->sc_e[i];
+	return sn;
+}
+
+template <class T>
+void SensorFleet<T>::drain(vector<SensorNode<T>>& sn_list, const double& t) {
+	//! The consumed energy only depends on the type, so it is computed once per type.
+	double drained[2] = { SENSOR_PARAMS[P_SENSOR_TYPE].drainEnergy(t), SENSOR_PARAMS[T_SENSOR_TYPE].drainEnergy(t) };
+
+	for (SensorNode<T>& sn : sn_list) {
+		const SensorParams& p = sn.getParams();
+		if (sn.SC_V <= p.SC_Vcritical) continue;
+		sn.SC_E -= drained[sn.getTypeId()];
+		sn.SC_V = sqrt(2 * sn.SC_E / p.SC_C);
+		sn.weight = p.weightOf(sn.SC_V);
+	}
+}
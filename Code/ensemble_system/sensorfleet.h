@@ -0,0 +1,99 @@
+/*! @file	sensorfleet.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "sensornode.h"
+
+#ifndef SENSORFLEET_H_
+#define SENSORFLEET_H_
+
+/*! @class		SensorFleet sensorfleet.h "sensorfleet.h"
+*   @brief		Implementation of @a SensorFleet class
+*
+*   The @a SensorFleet class is a read-only copy of a sensor node list as
+*   parallel arrays (x, y, voltage, energy, weight, type id), built once per
+*   run by @a FitnessEval . The node list stays the store of record. The
+*   constants of each type are read from @a SENSOR_PARAMS , so a node takes
+*   2 * sizeof(T) + 21 bytes (37 with double). @a node() rebuilds a
+*   @a SensorNode for code which needs the per-node interface.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+template <class T>
+class SensorFleet
+{
+	//! @publicsection
+public:
+	std::vector<T> xs;			/*!< x coordinates [m] */
+	std::vector<T> ys;			/*!< y coordinates [m] */
+	std::vector<double> sc_v;		/*!< Super capacitor voltages [V] */
+	std::vector<double> sc_e;		/*!< Super capacitor energies [J] */
+	std::vector<int> weights;		/*!< Recharge weights */
+	std::vector<uint8_t> types;		/*!< Rows in @a SENSOR_PARAMS */
+
+	//! An empty fleet.
+	SensorFleet() {}
+
+	/*! @brief			Copy the states of a sensor node list.
+	*   @param sn_list	A vector of all sensor nodes.
+	*/
+	explicit SensorFleet(const std::vector<SensorNode<T>>& sn_list) { this->assign(sn_list); }
+
+	/*! @brief			Replace the fleet with the states of a sensor node list.
+	*   @param sn_list	A vector of all sensor nodes.
+	*/
+	void assign(const std::vector<SensorNode<T>>& sn_list);
+
+	//! Access the number of sensor nodes.
+	size_t size() const { return this->xs.size(); }
+
+	//! Access the position of a sensor node.
+	Point<T> getPos(size_t i) const { return Point<T>(this->xs[i], this->ys[i]); }
+
+	//! Access the constants of the type of a sensor node.
+	const SensorParams& getParams(size_t i) const { return SENSOR_PARAMS[this->types[i]]; }
+
+	/*! @brief			Rebuild one sensor node, see @a SensorNode .
+	*   @param i		Index of the node.
+	*   @return			A sensor node with the same states and no sensing fails.
+	*/
+	SensorNode<T> node(size_t i) const;
+
+	//! Needed energy to fully recharge a sensor node, see @a SensorNode::calcPackage .
+	double calcPackage(size_t i) const {
+		const SensorParams& p = this->getParams(i);
+		return 0.5 * p.SC_C * (pow(p.SC_Vmax, 2.0) - pow(this->sc_v[i], 2.0));
+	}
+
+	//! Maximum energy of a sensor node, see @a SensorNode::calcMaxEnergy .
+	double calcMaxEnergy(size_t i) const {
+		const SensorParams& p = this->getParams(i);
+		return 0.5 * p.SC_C * pow(p.SC_Vmax, 2.0);
+	}
+
+	/*! @brief			Drain every node of a list above its critical voltage for @a t seconds.
+	*
+	*   Energy, voltage and weight are updated in place as by
+	*   @a SensorNode::updateEnergy , @a SensorNode::updateVolt and
+	*   @a SensorNode::updateWeight , with the drained energy computed once per type.
+	*
+	*   @param sn_list	A vector of all sensor nodes.
+	*   @param t		Spent time [s].
+	*/
+	static void drain(std::vector<SensorNode<T>>& sn_list, const double& t);
+};
+
+#endif // !SENSORFLEET_H_
@@ -26,47 +26,14 @@ SensorNode<T>::SensorNode() {
 
 template <class T>
 SensorNode<T>::SensorNode(float x, float y, double v, int w, bool p_type) {
-	// Common public member variables
 	this->pos = Point<T>(x, y);
 	this->SC_V = v;
 	this->weight = w;
 	this->p_sensor_type = p_type;
-	this->sense_cycle = 2e-3;
-	this->comm_cycle = 0.5;
+	this->time_to_change = this->getParams().time_to_change;
 	this->fails = 0;
 
-	if (p_type) {
-		//! Specific public member variables
-		this->SC_C = 3;
-		this->time_to_change = 1;
-		this->time_to_reset = 1;
-
-		//! Protected member variables
-		this->SC_Vmax = 5.;
-		this->SC_Vmin = 3.5;
-		this->SC_Vcritical = 3.3;
-		this->V_sense = 3.3;
-		this->I_sense = 1.2e-3;
-		this->I_idle = 4e-6;
-		this->idle_cycle = 9.498;
-	}
-	else {
-		//! Public member variables
-		this->SC_C = 6;
-		this->time_to_change = 10;
-		this->time_to_reset = 10;
-
-		//! Protected member variables
-		this->SC_Vmax = 2.5;
-		this->SC_Vmin = 1.75;
-		this->SC_Vcritical = 1.5;
-		this->V_sense = 1.5;
-		this->I_sense = 5.4e-6;
-		this->I_idle = 4e-9;
-		this->idle_cycle = 99.498;
-	}
-
-	this->SC_E = 0.5 * this->SC_C * this->SC_V * this->SC_V;
+	this->SC_E = 0.5 * this->getParams().SC_C * this->SC_V * this->SC_V;
 }
 
 template <class T>
@@ -74,35 +41,24 @@ SensorNode<T>::~SensorNode() {}
 
 template <class T>
 void SensorNode<T>::updateVolt(double& v) {
-	double temp_v = 2 * this->SC_E / this->SC_C;
+	double temp_v = 2 * this->SC_E / this->getParams().SC_C;
 	v = sqrt(temp_v);
 }
 
 template <class T>
 void SensorNode<T>::updateEnergy(double& e) {
-	e = 0.5 * this->SC_C * this->SC_V * this->SC_V;
+	e = 0.5 * this->getParams().SC_C * this->SC_V * this->SC_V;
 }
 
 template <class T>
 void SensorNode<T>::updateEnergy(const double& t, double& e) {
 	// t - unit: s
-	int cycles = static_cast<int>(floor(t / (3 * this->time_to_reset)));
-
-	e -= (cycles * this->sense_cycle * this->V_sense * this->I_sense
-		+ cycles * this->idle_cycle * this->I_idle * this->V_sense
-		+ cycles * this->comm_cycle * 2.45e-3);
+	e -= this->getParams().drainEnergy(t);
 }
 
 template <class T>
 void SensorNode<T>::updateWeight(const double& v, int& w) {
-	if (this->SC_Vmax - v <= 0.25) w = 10;	/*!< Be considered as full voltage */
-	else if (this->SC_Vmax - v > 0.25 && this->SC_Vmax - v <= 0.5) w = 9;
-	else if (this->SC_Vmax - v > 0.5 && this->SC_Vmax - v <= 0.75) w = 8;
-	else if (this->SC_Vmax - v > 0.75 && this->SC_Vmax - v <= 1.)  w = 7;
-	else if (this->SC_Vmax - v > 1. && this->SC_Vmax - v <= 1.25)  w = 6;
-	else if (this->SC_Vmax - v > 1.25 && this->SC_Vmax - v <= 1.5) w = 5;
-	else if (this->SC_Vmax - v > 1.5 && this->SC_Vmax - v <= 1.75) w = 4;
-	else w = 3;						/*!< Be considered as the lowest voltage */
+	w = this->getParams().weightOf(v);
 }
 
 template <class T>
@@ -114,33 +70,34 @@ double SensorNode<T>::acousTransfer(const double& d) {
 
 	this->updateVolt(this->SC_V);
 	//! Total voltage cannot exceed the maximum voltage level.
-	this->SC_V = std::min(this->SC_V, this->SC_Vmax);
+	this->SC_V = std::min(this->SC_V, this->getParams().SC_Vmax);
 
 	return temp_e;
 }
 
 template <class T>
 void SensorNode<T>::printSensorNodeInfo() {
+	const SensorParams& p = this->getParams();
 	this->pos.printPointLoc();
 
 	std::cout << "Sensor Node Information:" << std::endl << std::endl
-		<< "Capacitance: \t" << this->SC_C << " F" << std::endl
+		<< "Capacitance: \t" << p.SC_C << " F" << std::endl
 		<< "Capacitor Energy: \t" << this->SC_E << " J" << std::endl
 		<< "Capacitor Voltage: \t" << this->SC_E << " V" << std::endl
 		<< "Weight: \t" << this->weight << std::endl
 		<< "T: \t" << this->time_to_change << " s" << std::endl
-		<< "Original T: \t" << this->time_to_reset << " s" << std::endl
+		<< "Original T: \t" << p.time_to_reset << " s" << std::endl
 		<< "Fail times: \t" << this->fails << std::endl
-		<< "P sensor type? \t" << this->time_to_reset << std::endl
-		<< "Maximum Voltage: \t" << this->SC_Vmax << " V" << std::endl
-		<< "Minimum Voltage: \t" << this->SC_Vmin << " V" << std::endl
-		<< "Critical Voltage: \t" << this->SC_Vcritical << " V" << std::endl
+		<< "P sensor type? \t" << p.time_to_reset << std::endl
+		<< "Maximum Voltage: \t" << p.SC_Vmax << " V" << std::endl
+		<< "Minimum Voltage: \t" << p.SC_Vmin << " V" << std::endl
+		<< "Critical Voltage: \t" << p.SC_Vcritical << " V" << std::endl
 		<< "Current Voltage: \t" << this->SC_V << " V" << std::endl
-		<< "Sense Voltage: \t" << this->V_sense << " V" << std::endl
-		<< "Sense Current: \t" << this->I_sense << " A" << std::endl
-		<< "Idle Current: \t" << this->I_idle << " A" << std::endl
-		<< "Sense cycle duration: \t" << this->sense_cycle << " s" << std::endl
-		<< "Idle cycle duration: \t" << this->idle_cycle << " s" << std::endl
-		<< "Communication cycle duration: \t" << this->comm_cycle << " s" << std::endl
+		<< "Sense Voltage: \t" << p.V_sense << " V" << std::endl
+		<< "Sense Current: \t" << p.I_sense << " A" << std::endl
+		<< "Idle Current: \t" << p.I_idle << " A" << std::endl
+		<< "Sense cycle duration: \t" << p.sense_cycle << " s" << std::endl
+		<< "Idle cycle duration: \t" << p.idle_cycle << " s" << std::endl
+		<< "Communication cycle duration: \t" << p.comm_cycle << " s" << std::endl
 		<< std::endl;
 }
\ No newline at end of file
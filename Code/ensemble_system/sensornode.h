@@ -12,6 +12,7 @@
 
 
 #pragma once
+#include <cmath>
 #include "point.h"
 
 #ifndef SENSORNODE_H_
@@ -39,22 +40,86 @@
 /*! @} */
 
 
+//! Row of p-type (pressure) sensors in @a SENSOR_PARAMS
+#define P_SENSOR_TYPE 0
+//! Row of t-type (temperature) sensors in @a SENSOR_PARAMS
+#define T_SENSOR_TYPE 1
+
+/*! @struct		SensorParams sensornode.h "sensornode.h"
+*   @brief		Physical constants shared by all sensor nodes of one type
+*
+*   Only the voltage, energy, weight and fail count differ between two nodes
+*   of the same type, so the constants are kept once per type in
+*   @a SENSOR_PARAMS instead of in every node.
+*/
+struct SensorParams
+{
+	int time_to_change;		/*!< Default sense cycle duration [s] */
+	int time_to_reset;		/*!< Sensing cycle to reset [s] */
+	int SC_C;			/*!< Super Capacitor capacitance [F] */
+	double SC_Vmax;		/*!< Maximum voltage of super capacitor [V] */
+	double SC_Vmin;		/*!< Minimum voltage of super capacitor [V] */
+	double SC_Vcritical;		/*!< Critical voltage of super capacitor [V] */
+	double V_sense;		/*!< Voltage when sensing data [V] */
+	double I_sense;		/*!< Current when sensing data [A] */
+	double I_idle;		/*!< Current when in idle cycle [A] */
+	double sense_cycle;		/*!< Sense cycle duration [s] */
+	double idle_cycle;		/*!< Idle cycle duration [s] */
+	double comm_cycle;		/*!< Communication cycle duration [s] */
+
+	/*! @brief		Energy a node consumes in @a t seconds
+	*
+	*   Related formula: Energy consumption @f$ E = V* I* t @f$
+	*
+	*   @param t	Spent time [s]
+	*   @return		Consumed energy [J]
+	*/
+	double drainEnergy(const double& t) const {
+		int cycles = static_cast<int>(floor(t / (3 * this->time_to_reset)));
+		return cycles * this->sense_cycle * this->V_sense * this->I_sense
+			+ cycles * this->idle_cycle * this->I_idle * this->V_sense
+			+ cycles * this->comm_cycle * 2.45e-3;
+	}
+
+	/*! @brief		Recharge weight of a node at voltage @a v
+	*   @param v	Current voltage [V]
+	*   @return		Weight, 3: low, 10: full
+	*/
+	int weightOf(const double& v) const {
+		if (this->SC_Vmax - v <= 0.25) return 10;	/*!< Be considered as full voltage */
+		else if (this->SC_Vmax - v > 0.25 && this->SC_Vmax - v <= 0.5) return 9;
+		else if (this->SC_Vmax - v > 0.5 && this->SC_Vmax - v <= 0.75) return 8;
+		else if (this->SC_Vmax - v > 0.75 && this->SC_Vmax - v <= 1.)  return 7;
+		else if (this->SC_Vmax - v > 1. && this->SC_Vmax - v <= 1.25)  return 6;
+		else if (this->SC_Vmax - v > 1.25 && this->SC_Vmax - v <= 1.5) return 5;
+		else if (this->SC_Vmax - v > 1.5 && this->SC_Vmax - v <= 1.75) return 4;
+		return 3;						/*!< Be considered as the lowest voltage */
+	}
+};
+
+//! Parameters of p-type and t-type sensors, indexed by @a P_SENSOR_TYPE and @a T_SENSOR_TYPE
+inline constexpr SensorParams SENSOR_PARAMS[2] = {
+	{ 1, 1, 3, 5., 3.5, 3.3, 3.3, 1.2e-3, 4e-6, 2e-3, 9.498, 0.5 },
+	{ 10, 10, 6, 2.5, 1.75, 1.5, 1.5, 5.4e-6, 4e-9, 2e-3, 99.498, 0.5 }
+};
+
+
 /*! @class		SensorNode sensornode.h "sensornode.h"
 *   @brief		Implementation of @a SensorNode class
 *
 *   The @a SensorNode class includes basic attributes like voltage, energy,
 *   weight, etc. and actions like simulating energy consumption, updating weight,
-*   etc.
+*   etc. Constants of the sensor type are read from @a SENSOR_PARAMS .
 *
 *   @author		Qiuchen Qian
-*   @version	5
+*   @version	6
 *   @date		2020
 *   @warning	C4996 'strerror': This function or variable may be unsafe.
 *			Consider using strerror_s instead.
 *   @copyright	MIT Public License
 */
 template <class T>
-class SensorNode : protected Point<T>
+class SensorNode
 {
 	//! @publicsection
 public:
@@ -85,45 +150,51 @@ public:
 	~SensorNode();
 
 
-	/*! @brief			Access @c protected member variable @a SC_Vmin
-	*   @return			@c protected member variable @a SC_Vmin
+	//! Access the row of the sensor type in @a SENSOR_PARAMS
+	int getTypeId() const { return this->p_sensor_type ? P_SENSOR_TYPE : T_SENSOR_TYPE; }
+
+	//! Access the constants of the sensor type
+	const SensorParams& getParams() const { return SENSOR_PARAMS[this->getTypeId()]; }
+
+	/*! @brief			Access the minimum voltage of the sensor type
+	*   @return			@a SensorParams::SC_Vmin
 	*/
-	double getMinVolt() const { return this->SC_Vmin; }
+	double getMinVolt() const { return this->getParams().SC_Vmin; }
 
-	/*! @brief			Access @c protected member variable @a SC_Vmax
-	*   @return			@c protected member variable @a SC_Vmax
+	/*! @brief			Access the maximum voltage of the sensor type
+	*   @return			@a SensorParams::SC_Vmax
 	*/
-	double getMaxVolt() const { return this->SC_Vmax; }
+	double getMaxVolt() const { return this->getParams().SC_Vmax; }
 
-	/*! @brief			Access @c protected member variable @a SC_Vcritical
-	*   @return			@c protected member variable @a SC_Vcritical
+	/*! @brief			Access the critical voltage of the sensor type
+	*   @return			@a SensorParams::SC_Vcritical
 	*/
-	double getCriticalVolt() const { return this->SC_Vcritical; }
+	double getCriticalVolt() const { return this->getParams().SC_Vcritical; }
 
-	/*! @brief			Access @c protected member variable @a V_sense
-	*   @return			@c protected member variable @a V_sense
+	/*! @brief			Access the sensing voltage of the sensor type
+	*   @return			@a SensorParams::V_sense
 	*/
-	double getSenseVolt() const { return this->V_sense; }
+	double getSenseVolt() const { return this->getParams().V_sense; }
 
-	/*! @brief			Access @c protected member variable @a I_idle
-	*   @return			@c protected member variable @a I_idle
+	/*! @brief			Access the idle current of the sensor type
+	*   @return			@a SensorParams::I_idle
 	*/
-	double getIdleAmp() const { return this->I_idle; }
+	double getIdleAmp() const { return this->getParams().I_idle; }
 
-	/*! @brief			Access @c protected member variable @a idle_cycle
-	*   @return			@c protected member variable @a idle_cycle
+	/*! @brief			Access the idle cycle duration of the sensor type
+	*   @return			@a SensorParams::idle_cycle
 	*/
-	double getIdleCycle() const { return this->idle_cycle; }
+	double getIdleCycle() const { return this->getParams().idle_cycle; }
 
-	/*! @brief			Access @c protected member variable @a time_to_reset
-	*   @return			@c protected member variable @a time_to_reset
+	/*! @brief			Access the reset cycle of the sensor type
+	*   @return			@a SensorParams::time_to_reset
 	*/
-	int getTimeToReset() const { return this->time_to_reset; }
+	int getTimeToReset() const { return this->getParams().time_to_reset; }
 
-	/*! @brief			Access @c protected member variable @a SC_C
-	*   @return			@c protected member variable @a SC_C
+	/*! @brief			Access the capacitance of the sensor type
+	*   @return			@a SensorParams::SC_C
 	*/
-	int getCapacitance() const { return this->SC_C; }
+	int getCapacitance() const { return this->getParams().SC_C; }
 
 	/*! @brief			Access @c protected member variable @a fails
 	*   @return			@c protected member variable @a fails
@@ -143,7 +214,9 @@ public:
 	*
 	*   @return			Needed energy
 	*/
-	double calcPackage() { return 0.5 * this->SC_C * (pow(this->SC_Vmax, 2.0) - pow(this->SC_V, 2.0)); }
+	double calcPackage() const {
+		return 0.5 * this->getParams().SC_C * (pow(this->getParams().SC_Vmax, 2.0) - pow(this->SC_V, 2.0));
+	}
 
 	/*! @brief		Calculate maximum energy a sensor node could have
 	*
@@ -151,7 +224,7 @@ public:
 	*
 	*   @return		Maximum energy
 	*/
-	double calcMaxEnergy() { return 0.5 * this->SC_C * pow(this->SC_Vmax, 2.0); }
+	double calcMaxEnergy() const { return 0.5 * this->getParams().SC_C * pow(this->getParams().SC_Vmax, 2.0); }
 
 	/*! @brief		Update voltage according to current energy
 	*
@@ -167,7 +240,7 @@ public:
 	*
 	*   @param e	Energy variable to be updated
 	*/
-	virtual void updateEnergy(double& e);
+	void updateEnergy(double& e);
 
 	/*! @brief		Update sensor node energy according to spent time [s]
 	*
@@ -176,7 +249,7 @@ public:
 	*   @param t	time spent variable [s]
 	*   @param e	Energy to be updated [wh]
 	*/
-	virtual void updateEnergy(const double& t, double& e);
+	void updateEnergy(const double& t, double& e);
 
 	/*! @brief		Update weight according to current voltage
 	*  @param v	Current volatge
@@ -209,17 +282,6 @@ public:
 	//! @protectedsection
 protected:
 	int fails = 0;				/*!< Sensing fail times for a sensor node */
-	int time_to_reset = 1;			/*!< Sensing cycle to reset [s] */
-	int SC_C = 3;				/*!< Super Capacitor capacitance [F] */
-	double SC_Vmax = 5.;			/*!< Maximum voltage of super capacitor [V] */
-	double SC_Vmin = 3.5;			/*!< Minimum voltage of super capacitor [V] */
-	double SC_Vcritical = 3.3;		/*!< Critical voltage of super capacitor [V] */
-	double V_sense = 3.3;			/*!< Voltage when sensing data [V] */
-	double I_sense = 1.2e-3;		/*!< Current when sensing data [A] */
-	double I_idle = 4e-6;			/*!< Current when in idle cycle [A] */
-	double sense_cycle = 2e-3;		/*!< Sense cycle duration [s] */
-	double idle_cycle = 9.498;		/*!< Idle cycle duration [s] */
-	double comm_cycle = 0.5;		/*!< Communication cycle duration [s] */
 };							//! End of class SensorNode
 
 
@@ -0,0 +1,52 @@
+/*! @file solverstats.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include "solverstats.h"
+
+using namespace std;
+
+void SolverStats::reset() {
+	for (int64_t& t : this->phase_ns) t = 0;
+	for (uint64_t& n : this->events) n = 0;
+}
+
+void SolverStats::merge(const SolverStats& other) {
+	for (int i = 0; i < static_cast<int>(SolverPhase::NUM); i++) this->phase_ns[i] += other.phase_ns[i];
+	for (int i = 0; i < static_cast<int>(SolverEvent::NUM); i++) this->events[i] += other.events[i];
+}
+
+bool SolverStats::appendCsv(const string& fname, int case_num, double alg_time) const {
+	bool is_new = !ifstream(fname).good();
+
+	fstream file;
+	try {
+		file.open(fname, fstream::out | fstream::app);
+		if (!file.is_open()) throw runtime_error(fname + ": " + strerror(errno));
+	}
+	catch (const exception& e) {
+		cerr << e.what() << "\n";
+		return false;
+	}
+
+	if (is_new) {
+		file << "case,alg_time,load_ms,init_score_ms,moves_ms,eval_ms,selection_ms,"
+			<< "fitness_calls,dist_evals,cluster_builds,swaps,accepted" << endl;
+	}
+	file << case_num << "," << alg_time;
+	for (int i = 0; i < static_cast<int>(SolverPhase::NUM); i++) file << "," << this->phase_ns[i] * 1e-6;
+	for (int i = 0; i < static_cast<int>(SolverEvent::NUM); i++) file << "," << this->events[i];
+	file << endl;
+	file.close();
+
+	return true;
+}
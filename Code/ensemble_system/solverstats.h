@@ -0,0 +1,145 @@
+/*! @file	solverstats.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#ifndef SOLVERSTATS_H_
+#define SOLVERSTATS_H_
+
+/*! @def		ODP_SOLVER_STATS
+*   Define it (e.g. -DODP_SOLVER_STATS) to build the phase timers and event
+*   counters into the solvers. Without it every @a SOLVER_PHASE and
+*   @a SOLVER_COUNT is removed by the preprocessor.
+*/
+
+//! Solver phases timed by @a SolverStats .
+enum class SolverPhase
+{
+	LOAD,			/*!< Loading or building the initial population */
+	INIT_SCORE,		/*!< Scoring the initial population */
+	MOVES,			/*!< Crossover, attraction or SA moves */
+	EVAL,			/*!< Scoring the changed sub paths */
+	SELECTION,		/*!< Keeping the better solutions */
+	NUM
+};
+
+//! Solver events counted by @a SolverStats .
+enum class SolverEvent
+{
+	FITNESS_CALLS,		/*!< Sub paths scored */
+	DIST_EVALS,		/*!< Distances read while scoring */
+	CLUSTER_BUILDS,		/*!< Sub paths built by the initial guess builder */
+	SWAPS,			/*!< Node swaps made by moves */
+	ACCEPTED,		/*!< Moves kept: GA trails replacing targets, BH stars changed, SA steps accepted */
+	NUM
+};
+
+/*! @class		SolverStats solverstats.h "solverstats.h"
+*   @brief		Implementation of @a SolverStats class
+*
+*   The @a SolverStats class holds phase times and event counts of one solver
+*   run. Every worker thread fills its own copy (kept in its @a EvalScratch),
+*   and the copies are merged when the run ends, so nothing is shared on the
+*   hot paths. Phases run by the workers are timed per worker, so a phase time
+*   is the thread time summed over workers and equals wall time on one thread.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+class SolverStats
+{
+	//! @publicsection
+public:
+	//! A default constructer with all times and counts zero.
+	SolverStats() { this->reset(); }
+
+	//! Check if the statistics are built in.
+	static constexpr bool enabled() {
+#ifdef ODP_SOLVER_STATS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	//! Set all times and counts to zero.
+	void reset();
+
+	//! Add the times and counts of @a other .
+	void merge(const SolverStats& other);
+
+	//! Add @a ns nanoseconds to @a phase .
+	void addTime(SolverPhase phase, int64_t ns) { this->phase_ns[static_cast<int>(phase)] += ns; }
+
+	//! Add @a n to @a event .
+	void count(SolverEvent event, uint64_t n) { this->events[static_cast<int>(event)] += n; }
+
+	//! Access the time of @a phase [ms].
+	double getTime(SolverPhase phase) const { return this->phase_ns[static_cast<int>(phase)] * 1e-6; }
+
+	//! Access the count of @a event .
+	uint64_t getCount(SolverEvent event) const { return this->events[static_cast<int>(event)]; }
+
+	/*! @brief			Append one line to a csv sidecar of the summaries, with a header if the file is new.
+	*   @param fname		Path of the csv file.
+	*   @param case_num	The case id.
+	*   @param alg_time	Total algorithm time [ms].
+	*   @return			If the line is written, return true.
+	*/
+	bool appendCsv(const std::string& fname, int case_num, double alg_time) const;
+
+	//! @privatesection
+private:
+	int64_t phase_ns[static_cast<int>(SolverPhase::NUM)];
+	uint64_t events[static_cast<int>(SolverEvent::NUM)];
+};
+
+/*! @class		PhaseTimer solverstats.h "solverstats.h"
+*   @brief		Adds the time from its construction to its destruction to one phase.
+*/
+class PhaseTimer
+{
+public:
+	PhaseTimer(SolverStats& stats, SolverPhase phase) : stats(stats), phase(phase),
+		start(std::chrono::steady_clock::now()) {}
+
+	~PhaseTimer() {
+		this->stats.addTime(this->phase, std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - this->start).count());
+	}
+
+	PhaseTimer(const PhaseTimer&) = delete;
+	PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+	SolverStats& stats;
+	SolverPhase phase;
+	std::chrono::steady_clock::time_point start;
+};
+
+#define SOLVER_STATS_CAT2(a, b) a##b
+#define SOLVER_STATS_CAT(a, b) SOLVER_STATS_CAT2(a, b)
+
+#ifdef ODP_SOLVER_STATS
+//! Time the rest of the enclosing scope as @a phase .
+#define SOLVER_PHASE(stats, phase) PhaseTimer SOLVER_STATS_CAT(phase_timer_, __LINE__)((stats), SolverPhase::phase)
+//! Count @a n events of kind @a event .
+#define SOLVER_COUNT(stats, event, n) (stats).count(SolverEvent::event, (n))
+#else
+#define SOLVER_PHASE(stats, phase) ((void)0)
+#define SOLVER_COUNT(stats, event, n) ((void)0)
+#endif
+
+#endif // !SOLVERSTATS_H_
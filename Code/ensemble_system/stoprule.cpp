@@ -0,0 +1,67 @@
+/*! @file stoprule.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include <cmath>
+#include "stoprule.h"
+
+using namespace std;
+
+const char* stopReasonName(StopReason reason) {
+	switch (reason) {
+	case StopReason::STAGNATION: return "stagnation";
+	case StopReason::LOW_ACCEPTANCE: return "low_acceptance";
+	case StopReason::DEADLINE: return "deadline";
+	default: return "completed";
+	}
+}
+
+bool StopTracker::update(double best) {
+	if (this->reason != StopReason::COMPLETED) return true;
+	if (this->deadline && this->deadline->expired()) {
+		this->reason = StopReason::DEADLINE;
+		return true;
+	}
+
+	if (!this->started || best > this->best + this->rule.min_rel_gain * fabs(this->best)) {
+		this->started = true;
+		this->best = best;
+		this->idle = 0;
+		return false;
+	}
+
+	//! Smaller gains still raise the reference, so a slow drift is measured from the latest best.
+	if (best > this->best) this->best = best;
+	if (this->rule.patience > 0 && ++this->idle >= this->rule.patience) {
+		this->reason = StopReason::STAGNATION;
+		return true;
+	}
+	return false;
+}
+
+bool StopTracker::update(double best, int n_acc, int n_moves) {
+	if (this->update(best)) return true;
+	if (this->rule.min_accept <= 0.) return false;
+
+	if (this->window.empty()) this->window.assign(2 * STOP_ACCEPT_WINDOW, 0);
+	int* slot = &this->window[2 * this->window_pos];
+	this->window_acc += n_acc - slot[0];
+	this->window_moves += n_moves - slot[1];
+	slot[0] = n_acc;
+	slot[1] = n_moves;
+
+	//! Only judge full windows, a cold start must not stop the search.
+	bool full = ++this->window_pos == STOP_ACCEPT_WINDOW || this->window_full;
+	if (this->window_pos == STOP_ACCEPT_WINDOW) this->window_pos = 0;
+	this->window_full = full;
+
+	if (full && this->window_acc < this->rule.min_accept * this->window_moves) {
+		this->reason = StopReason::LOW_ACCEPTANCE;
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,137 @@
+/*! @file	stoprule.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <chrono>
+#include <vector>
+
+#ifndef STOPRULE_H_
+#define STOPRULE_H_
+
+//! SA steps over which the acceptance ratio is measured
+#define STOP_ACCEPT_WINDOW 50
+
+//! Why a solver stopped.
+enum class StopReason
+{
+	COMPLETED,		/*!< All generations (or the whole cooling schedule) were run */
+	STAGNATION,		/*!< The best fitness did not improve for @a StopRule::patience steps */
+	LOW_ACCEPTANCE,		/*!< SA accepted fewer moves than @a StopRule::min_accept */
+	DEADLINE		/*!< @a StopRule::time_budget ran out */
+};
+
+//! Name of @a reason written to the summaries.
+const char* stopReasonName(StopReason reason);
+
+/*! @struct		StopRule stoprule.h "stoprule.h"
+*   @brief		Early termination settings shared by GA, BH and SA
+*
+*   The rules only end the existing loops earlier, so a run with all rules
+*   disabled (the default) is unchanged. A step is a generation for GA and BH,
+*   and a temperature step of a chain (or an exchange round with tempering)
+*   for SA. The time budget starts when @a calcFinalPath is entered, so it
+*   covers the fitness tables (distance oracle, acoustic graph, PDV count) and
+*   the initial guesses as well as the search, a longer span than @a alg_time ,
+*   but at least one step is always run.
+*/
+struct StopRule
+{
+	int patience = 0;		/*!< Stop after this many steps without improvement, 0 to disable */
+	double min_rel_gain = 0.;	/*!< Relative gain of the best fitness needed to count as an improvement */
+	double min_accept = 0.;		/*!< SA only: stop when the acceptance ratio over STOP_ACCEPT_WINDOW steps falls below it, 0 to disable */
+	long long time_budget = 0;	/*!< Wall-clock budget of one run in milliseconds, 0 to disable */
+
+	//! Check if any rule is enabled.
+	bool isEnabled() const { return this->patience > 0 || this->min_accept > 0. || this->time_budget > 0; }
+};
+
+/*! @class		Deadline stoprule.h "stoprule.h"
+*   @brief		End of a wall-clock budget
+*
+*   A disabled deadline never expires and does not read the clock.
+*/
+class Deadline
+{
+	//! @publicsection
+public:
+	/*! @brief			Start a budget now.
+	*   @param budget		Budget in milliseconds, 0 to disable.
+	*/
+	explicit Deadline(long long budget = 0) : enabled(budget > 0),
+		end(std::chrono::steady_clock::now() + std::chrono::milliseconds(budget)) {}
+
+	//! Check if the budget ran out.
+	bool expired() const { return this->enabled && std::chrono::steady_clock::now() >= this->end; }
+
+	//! @privatesection
+private:
+	bool enabled;
+	std::chrono::steady_clock::time_point end;
+};
+
+/*! @class		StopTracker stoprule.h "stoprule.h"
+*   @brief		Implementation of @a StopTracker class
+*
+*   The @a StopTracker class applies a @a StopRule to one search: it is fed the
+*   best fitness (and, for SA, if each step was accepted) after every step and
+*   tells when the search should end. Each SA chain has its own tracker, all
+*   of them sharing the @a Deadline of the run.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+class StopTracker
+{
+	//! @publicsection
+public:
+	//! A tracker which never stops.
+	StopTracker() {}
+
+	/*! @brief			A tracker applying @a rule .
+	*   @param rule		Stop rules of the run.
+	*   @param deadline	Deadline of the run, or a null pointer to ignore @a StopRule::time_budget .
+	*/
+	explicit StopTracker(const StopRule& rule, const Deadline* deadline = nullptr) : rule(rule), deadline(deadline) {}
+
+	/*! @brief			Record the best fitness after a step.
+	*   @param best		The best fitness so far.
+	*   @return			True if the search should stop.
+	*/
+	bool update(double best);
+
+	/*! @brief			Record the best fitness and acceptance of an SA step.
+	*   @param best		The best fitness so far.
+	*   @param n_acc		Moves accepted in the step.
+	*   @param n_moves	Moves tried in the step.
+	*   @return			True if the search should stop.
+	*/
+	bool update(double best, int n_acc, int n_moves);
+
+	//! Access why the search should stop, @a StopReason::COMPLETED while it should not.
+	StopReason getReason() const { return this->reason; }
+
+	//! @privatesection
+private:
+	StopRule rule;
+	const Deadline* deadline = nullptr;
+	StopReason reason = StopReason::COMPLETED;
+	bool started = false;
+	double best = 0.;
+	int idle = 0;			/*!< Steps since the last improvement */
+	std::vector<int> window;	/*!< Accepted and tried moves of the last steps, in pairs */
+	int window_pos = 0;
+	bool window_full = false;
+	int window_acc = 0;
+	int window_moves = 0;
+};
+
+#endif // !STOPRULE_H_
@@ -0,0 +1,78 @@
+/*! @file threadpool.cpp
+ *
+ *  @warning This is the internal cpp file of the ODP project.
+ *  Do not use it directly in other code.
+ *  Copyright (C) Qiuchen Qian, 2020
+ *  Imperial College, London
+ */
+
+#include "threadpool.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool(int n_threads) : next_i(0) {
+	if (n_threads <= 0) n_threads = static_cast<int>(thread::hardware_concurrency());
+	if (n_threads <= 0) n_threads = 1;
+	this->n_workers = n_threads;
+
+	this->workers.reserve(n_threads - 1);
+	for (int i = 1; i < n_threads; i++) {
+		this->workers.push_back(thread(&ThreadPool::workerLoop, this, i));
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		lock_guard<mutex> lock(this->mtx);
+		this->stop = true;
+	}
+	this->cv_start.notify_all();
+	for (unsigned i = 0; i < this->workers.size(); i++) this->workers[i].join();
+}
+
+void ThreadPool::parallelFor(int n, const function<void(int, int)>& body) {
+	if (n <= 0) return;
+	if (this->workers.empty() || n == 1) {
+		for (int i = 0; i < n; i++) body(i, 0);
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(this->mtx);
+		this->job = &body;
+		this->job_n = n;
+		this->next_i = 0;
+		this->n_busy = this->workers.size();
+		this->epoch++;
+	}
+	this->cv_start.notify_all();
+
+	this->runJob(0);
+
+	unique_lock<mutex> lock(this->mtx);
+	this->cv_done.wait(lock, [this] { return this->n_busy == 0; });
+	this->job = nullptr;
+}
+
+void ThreadPool::runJob(int worker) {
+	for (int i = this->next_i++; i < this->job_n; i = this->next_i++) (*this->job)(i, worker);
+}
+
+void ThreadPool::workerLoop(int worker) {
+	unsigned long long seen = 0;
+	while (true) {
+		{
+			unique_lock<mutex> lock(this->mtx);
+			this->cv_start.wait(lock, [this, &seen] { return this->stop || this->epoch != seen; });
+			if (this->stop) return;
+			seen = this->epoch;
+		}
+
+		this->runJob(worker);
+
+		{
+			lock_guard<mutex> lock(this->mtx);
+			if (--this->n_busy == 0) this->cv_done.notify_one();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+/*! @file	threadpool.h
+*
+*   @warning This is the internal header of the ODP project.
+*   Do not use it directly in other code.
+*
+*   Copyright (C) Qiuchen Qian, 2020
+*   Imperial College, London
+*/
+
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+/*! @class		ThreadPool threadpool.h "threadpool.h"
+*   @brief		Implementation of @a ThreadPool class
+*
+*   The @a ThreadPool class keeps a fixed set of worker threads alive for a whole
+*   run, so that independent loop iterations (e.g. fitness evaluations of a
+*   population) can be shared between cores without creating threads for each
+*   generation. The calling thread works as worker 0. Every worker gets its own
+*   id in [0, @a getThreadNum()), which can be used to index per-worker scratch
+*   buffers.
+*
+*   @author		Qiuchen Qian
+*   @version	1
+*   @date		2020
+*   @copyright	MIT Public License
+*/
+class ThreadPool
+{
+	//! @publicsection
+public:
+	/*! @brief			Start the worker threads.
+	*   @param n_threads	Number of workers including the calling thread, 0 for all hardware threads.
+	*/
+	explicit ThreadPool(int n_threads = 0);
+
+	//! A destructer which joins all worker threads.
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/*! @brief			Access the number of workers.
+	*   @return			The number of workers including the calling thread.
+	*/
+	int getThreadNum() const { return this->n_workers; }
+
+	/*! @brief			Run @a body for every index in [0, @a n) and wait for all of them.
+	*
+	*   Indices are handed out one by one, so the assignment of indices to workers
+	*   changes from run to run. @a body must only write data owned by its index
+	*   or by its worker.
+	*
+	*   @param n		Number of iterations.
+	*   @param body		Loop body called as body(index, worker id).
+	*/
+	void parallelFor(int n, const std::function<void(int, int)>& body);
+
+	//! @privatesection
+private:
+	int n_workers = 1;						/*!< Number of workers including the calling thread */
+	std::vector<std::thread> workers;			/*!< Background threads */
+	std::mutex mtx;
+	std::condition_variable cv_start;			/*!< Signals a new job or shutdown */
+	std::condition_variable cv_done;			/*!< Signals all background workers finished a job */
+	const std::function<void(int, int)>* job = nullptr;	/*!< Current loop body */
+	int job_n = 0;						/*!< Number of iterations of the current job */
+	std::atomic<int> next_i;				/*!< Next iteration to hand out */
+	int n_busy = 0;						/*!< Background workers still running the current job */
+	unsigned long long epoch = 0;				/*!< Job counter */
+	bool stop = false;
+
+	//! Take iterations of the current job until none is left.
+	void runJob(int worker);
+
+	//! Main loop of a background worker.
+	void workerLoop(int worker);
+};
+
+#endif // !THREADPOOL_H_
\ No newline at end of file
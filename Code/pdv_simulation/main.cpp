@@ -80,11 +80,10 @@ vector<SensorNode<float>> readFullData(int pdv_num, string fname = "") {
 	}
 	file.close();
 
-	for (unsigned i = 0; i < sn_list.size() - 1; i++) {
-		for (unsigned j = i + 1; j < sn_list.size(); j++) {
-			if (sn_list[i].pos.isCoincide(sn_list[j].pos)) {
-				throw invalid_argument("Exist duplicates in sensor node deployment !");
-			}
+	PointGrid<float> grid(COINCIDE_TOL, sn_list.size());
+	for (unsigned i = 0; i < sn_list.size(); i++) {
+		if (!grid.insertUnique(sn_list[i].pos)) {
+			throw invalid_argument("Exist duplicates in sensor node deployment !");
 		}
 	}
 
@@ -125,11 +124,10 @@ vector<Point<float>> readSubData(int num, string fname = "") {
 	}
 	file.close();
 
-	for (unsigned i = 0; i < path.size() - 1; i++) {
-		for (unsigned j = i + 1; j < path.size(); j++) {
-			if (path[i].isCoincide(path[j])) {
-				throw invalid_argument("Exist duplicate points in the flight path !");
-			}
+	PointGrid<float> grid(COINCIDE_TOL, path.size());
+	for (unsigned i = 0; i < path.size(); i++) {
+		if (!grid.insertUnique(path[i])) {
+			throw invalid_argument("Exist duplicate points in the flight path !");
 		}
 	}
 
@@ -126,6 +126,9 @@ float PDV<T>::flightSimulation(int cnt, double& charged_e, double& pdv_t, vector
 
 	// Calculate descent energy in advance
 	this->descentEnergyCost(descent_t, temp_des);
+
+	PointGrid<T> sn_grid(COINCIDE_TOL, sn_list.size());
+	for (unsigned i = 0; i < sn_list.size(); i++) sn_grid.insert(sn_list[i].pos);
 	
 	do {			// SJN method
 		vector<double> d_list = this->pos.calcDist(path);
@@ -139,14 +142,8 @@ float PDV<T>::flightSimulation(int cnt, double& charged_e, double& pdv_t, vector
 		this->rthEnergyCost(rand_offset, path[next], rth_gps_t, temp_rth_gps);
 		this->uwbEnergyCost(rand_offset, rth_uwb_t, temp_rth_uwb);
 
-		int this_cn = -1;
-		for (unsigned i = 0; i < sn_list.size(); i++) {
-			if (sn_list[i].pos.isCoincide(path[next])) {
-				this->iptEnergyCost(sn_list[i], temp_ipt);
-				this_cn = i;
-				break;
-			}
-		}
+		int this_cn = sn_grid.findCoincide(path[next]);
+		if (this_cn >= 0) this->iptEnergyCost(sn_list[this_cn], temp_ipt);
 
 		if (temp_rth_gps + temp_rth_uwb + temp_gps + temp_uwb + temp_des + temp_ipt + 18.7 > this->getPdvEnergy()) {
 			break;
@@ -84,17 +84,14 @@ float PDV<T>::flightSimulation(double& charged_e, double& pdv_t, vector<SensorNo
 	charged_e = 0.;
 	pdv_t = 0.;
 
+	PointGrid<T> sn_grid(COINCIDE_TOL, sn_list.size());
+	for (unsigned i = 0; i < sn_list.size(); i++) sn_grid.insert(sn_list[i].pos);
+
 	do {			// SJN method
 		vector<double> d_list = this->pos.calcDist(path);
 		int next = distance(d_list.begin(), min_element(d_list.begin(), d_list.end()));
 
-		int this_cn = -1;
-		for (unsigned i = 0; i < sn_list.size(); i++) {
-			if (sn_list[i].pos.isCoincide(path[next])) {
-				this_cn = i;
-				break;
-			}
-		}
+		int this_cn = sn_grid.findCoincide(path[next]);
 
 		if (this->calcEnergyCost(path[next].calcDist(Point<T>()) / this->f_speed) + 
 			this->calcEnergyCost(this->pos.calcDist(path[next]) / this->f_speed) > this->f_eng) {
@@ -11,6 +11,7 @@
  */
 
 
+#include <cmath>
 #include <iostream>
 #include "point.h"
 
@@ -44,7 +45,7 @@ std::vector<double> Point<T>::calcDist(const std::vector<Point<T>>& p_list) {
 
 template <class T>
 bool Point<T>::isCoincide(const Point<T>& p) {
-	if (this->calcDist(p) <= 1e-2) return true;
+	if (this->calcDist(p) <= COINCIDE_TOL) return true;
 	return false;
 }
 
@@ -53,3 +54,51 @@ void Point<T>::printPointLoc() {
 	std::cout << "Coordinate: [ " << this->x_ << " , " << this->y_ << " ]"
 		<< std::endl << std::endl;
 }
+
+template <class T>
+PointGrid<T>::PointGrid(double tol, size_t n_hint) : tol(tol), cell(tol * (1. + 1e-6)) {
+	this->heads.reserve(n_hint);
+	this->prev.reserve(n_hint);
+	this->pts.reserve(n_hint);
+}
+
+template <class T>
+int64_t PointGrid<T>::cellOf(const T& v) const {
+	return static_cast<int64_t>(std::floor(v / this->cell));
+}
+
+template <class T>
+int PointGrid<T>::insert(const Point<T>& p) {
+	int id = this->pts.size();
+	uint64_t key = cellKey(this->cellOf(p.getX()), this->cellOf(p.getY()));
+	auto it = this->heads.find(key);
+	this->prev.push_back(it == this->heads.end() ? -1 : it->second);
+	this->heads[key] = id;
+	this->pts.push_back(p);
+	return id;
+}
+
+template <class T>
+int PointGrid<T>::findCoincide(const Point<T>& p) const {
+	int64_t cx = this->cellOf(p.getX()), cy = this->cellOf(p.getY());
+	int found = -1;
+	for (int64_t i = cx - 1; i <= cx + 1; i++) {
+		for (int64_t j = cy - 1; j <= cy + 1; j++) {
+			auto it = this->heads.find(cellKey(i, j));
+			if (it == this->heads.end()) continue;
+			for (int id = it->second; id >= 0; id = this->prev[id]) {
+				if ((found < 0 || id < found) && std::hypot(this->pts[id].getX() - p.getX(), this->pts[id].getY() - p.getY()) <= this->tol) {
+					found = id;
+				}
+			}
+		}
+	}
+	return found;
+}
+
+template <class T>
+bool PointGrid<T>::insertUnique(const Point<T>& p) {
+	if (this->findCoincide(p) >= 0) return false;
+	this->insert(p);
+	return true;
+}